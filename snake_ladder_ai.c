@@ -0,0 +1,299 @@
+/*SNAKE & LADDER GAME - EXPECTIMAX COMPUTER OPPONENT*/
+// The computer looks ahead over its own and its opponent's decisions and
+// averages over the dice (expectimax). Decisions only exist in variants:
+// which token to move, whether a token that would overshoot an exact
+// finish can move at all, and whether to use a six's bonus roll on
+// another token. In the chosen-rolls rule of the SDL game the roll itself
+// is the decision and there is no chance node.
+//
+// Search runs in iterations of growing depth until the time budget is
+// spent; the deepest finished iteration's move is played. Chance nodes are
+// cached in a fixed-size transposition table, so memory never grows with
+// the search. Leaves are scored by each side's expected turns to bring its
+// tokens home.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include "snake_ladder_ai.h"
+
+// Monotonic clock in seconds
+static double now_seconds() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// Where a token on a square goes with a roll: the board's square count
+// when it gets home, -1 when it cannot move
+static int square_target(const Board* board, const VariantRules* rules, int square, int roll) {
+    int squares = board->squares;
+    if (square >= squares) return -1;
+
+    int to = square + roll;
+    if (to >= squares) return rules->exact_finish && to > squares ? -1 : squares;
+    to = board_jump(board, to);
+    return to < squares ? to : squares;
+}
+
+// Start a variant game with every token off the board
+void variant_init(VariantState* state) {
+    memset(state, 0, sizeof(*state));
+    state->winner = -1;
+}
+
+// Where the current player's token goes with a roll, or -1
+int variant_token_target(const Board* board, const VariantRules* rules, const VariantState* state,
+                         int token, int roll) {
+    return square_target(board, rules, state->position[state->current][token], roll);
+}
+
+// List the current player's moves for a roll (every roll if rolls are
+// chosen and roll is 0). Tokens sharing a square are one move. With no
+// token able to move, the only move is to pass.
+int variant_legal_moves(const Board* board, const VariantRules* rules, const VariantState* state,
+                        int roll, AiMove* moves) {
+    const int32_t* position = state->position[state->current];
+    int first = roll, last = roll, count = 0;
+    if (rules->chosen_rolls && roll == 0) {
+        first = 1;
+        last = DICE_SIDES;
+    }
+
+    for (int r = first; r <= last; r++) {
+        for (int token = 0; token < rules->tokens; token++) {
+            int duplicate = 0;
+            for (int other = 0; other < token; other++) {
+                if (position[other] == position[token]) duplicate = 1;
+            }
+            if (duplicate || variant_token_target(board, rules, state, token, r) < 0) continue;
+            moves[count++] = (AiMove){r, token};
+        }
+    }
+    if (count == 0) moves[count++] = (AiMove){first, -1};
+    return count;
+}
+
+// Play a move and pass the turn, unless a six earned another roll
+void variant_apply(const Board* board, const VariantRules* rules, VariantState* state, AiMove move) {
+    int player = state->current;
+
+    if (move.token >= 0) {
+        state->position[player][move.token] = variant_token_target(board, rules, state, move.token, move.roll);
+
+        int home = 1;
+        for (int token = 0; token < rules->tokens; token++) {
+            if (state->position[player][token] < board->squares) home = 0;
+        }
+        if (home) {
+            state->winner = player;
+            return;
+        }
+        if (rules->bonus_six && move.roll == DICE_SIDES) return;
+    }
+    state->current = 1 - player;
+}
+
+// Expected turns for one token to get home from every square, by value
+// iteration; with chosen rolls this is the fewest rolls. Bonus rolls are
+// left out of the estimate.
+static void compute_token_turns(const Board* board, const VariantRules* rules, double* turns) {
+    int squares = board->squares;
+    double change = 1.0;
+
+    for (int square = 0; square <= squares; square++) turns[square] = 0.0;
+    for (int sweep = 0; sweep < 100000 && change > 1e-9; sweep++) {
+        change = 0.0;
+        for (int square = squares - 1; square >= 0; square--) {
+            double sum = 0.0, best = INFINITY;
+            int stuck = 0;
+            for (int roll = 1; roll <= DICE_SIDES; roll++) {
+                int to = square_target(board, rules, square, roll);
+                if (to < 0) {
+                    stuck++;
+                    continue;
+                }
+                sum += turns[to];
+                if (turns[to] < best) best = turns[to];
+            }
+
+            // Rolls that cannot move leave the token here for another turn
+            double value = rules->chosen_rolls ? 1.0 + best
+                                               : (DICE_SIDES + sum) / (DICE_SIDES - stuck);
+            if (fabs(value - turns[square]) > change) change = fabs(value - turns[square]);
+            turns[square] = value;
+        }
+    }
+}
+
+// Zobrist key number i of a board: a full 64-bit SplitMix64 output, so no
+// two squares share a key
+static uint64_t zobrist_key(uint64_t base, int i) {
+    uint64_t z = base + (uint64_t)(i + 1) * 0x9E3779B97F4A7C15ULL;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+// Set up a search for a board and variant with a transposition table of
+// table_entries (rounded down to a power of two)
+int ai_init(AiSearch* search, const Board* board, const VariantRules* rules, long table_entries) {
+    int keys = AI_PLAYERS * (board->squares + 1) + 1;
+    long size = 1;
+    while (size * 2 <= table_entries) size *= 2;
+
+    memset(search, 0, sizeof(*search));
+    if (rules->tokens < 1 || rules->tokens > AI_MAX_TOKENS) {
+        printf("Variants have 1 to %d tokens per player!\n", AI_MAX_TOKENS);
+        return 0;
+    }
+    search->board = board;
+    search->rules = *rules;
+    search->max_depth = AI_MAX_DEPTH;
+    search->table_mask = size - 1;
+    search->token_turns = malloc(sizeof(double) * (board->squares + 1));
+    search->zobrist = malloc(sizeof(uint64_t) * keys);
+    search->table = calloc(size, sizeof(AiEntry));
+    if (!search->token_turns || !search->zobrist || !search->table) {
+        printf("Out of memory in AI search!\n");
+        ai_free(search);
+        return 0;
+    }
+
+    uint64_t base = board_hash(board);
+    for (int i = 0; i < keys; i++) search->zobrist[i] = zobrist_key(base, i);
+    compute_token_turns(board, rules, search->token_turns);
+    return 1;
+}
+
+// Release a search
+void ai_free(AiSearch* search) {
+    free(search->token_turns);
+    free(search->zobrist);
+    free(search->table);
+    search->token_turns = NULL;
+    search->zobrist = NULL;
+    search->table = NULL;
+}
+
+// Key of a position. Keys are summed rather than XORed so that tokens are
+// interchangeable and two tokens on one square do not cancel out.
+static uint64_t state_key(const AiSearch* search, const VariantState* state) {
+    int stride = search->board->squares + 1;
+    uint64_t key = state->current ? search->zobrist[AI_PLAYERS * stride] : 0;
+
+    for (int player = 0; player < AI_PLAYERS; player++) {
+        for (int token = 0; token < search->rules.tokens; token++) {
+            key += search->zobrist[player * stride + state->position[player][token]];
+        }
+    }
+    return key;
+}
+
+// Score a position for the searching player: the opponent's expected turns
+// to finish less its own, plus half a turn for having the move
+double ai_evaluate(const AiSearch* search, const VariantState* state) {
+    double own = 0.0, other = 0.0;
+
+    if (state->winner >= 0) return state->winner == search->ai_player ? AI_WIN_SCORE : -AI_WIN_SCORE;
+    for (int token = 0; token < search->rules.tokens; token++) {
+        own += search->token_turns[state->position[search->ai_player][token]];
+        other += search->token_turns[state->position[1 - search->ai_player][token]];
+    }
+    return other - own + (state->current == search->ai_player ? 0.5 : -0.5);
+}
+
+static double chance_value(AiSearch* search, const VariantState* state, int depth);
+
+// Best value over the current player's moves for a roll: the searching
+// player maximizes, the opponent minimizes
+static double decision_value(AiSearch* search, const VariantState* state, int roll, int depth) {
+    AiMove moves[DICE_SIDES * AI_MAX_TOKENS];
+    int count = variant_legal_moves(search->board, &search->rules, state, roll, moves);
+    int maximize = state->current == search->ai_player;
+    double best = maximize ? -INFINITY : INFINITY;
+
+    for (int i = 0; i < count && !search->aborted; i++) {
+        VariantState next = *state;
+        variant_apply(search->board, &search->rules, &next, moves[i]);
+        double value = chance_value(search, &next, depth - 1);
+        if (maximize ? value > best : value < best) best = value;
+    }
+    return best;
+}
+
+// Expected value of a position before its roll, depth plies deep
+static double chance_value(AiSearch* search, const VariantState* state, int depth) {
+    // Sooner wins score higher and sooner losses lower
+    if (state->winner >= 0) {
+        return state->winner == search->ai_player ? AI_WIN_SCORE + depth : -AI_WIN_SCORE - depth;
+    }
+    if (depth <= 0) return ai_evaluate(search, state);
+
+    if (++search->nodes % AI_CLOCK_NODES == 0 && now_seconds() > search->deadline) search->aborted = 1;
+    if (search->aborted) return 0.0;
+
+    uint64_t key = state_key(search, state);
+    AiEntry* entry = &search->table[key & search->table_mask];
+    if (entry->key == key && entry->depth == depth) return entry->value;
+
+    double value;
+    if (search->rules.chosen_rolls) {
+        value = decision_value(search, state, 0, depth);
+    } else {
+        value = 0.0;
+        for (int roll = 1; roll <= DICE_SIDES; roll++) value += decision_value(search, state, roll, depth);
+        value /= DICE_SIDES;
+    }
+
+    // Keep the deeper result when two positions share a slot
+    if (!search->aborted && (entry->key != key || depth >= entry->depth)) {
+        *entry = (AiEntry){key, value, (int16_t)depth};
+    }
+    return value;
+}
+
+// Choose the current player's move for a roll (0 to choose the roll too
+// under chosen rolls), searching deeper until budget_ms runs out. The
+// first iteration always completes, so a move is found however short the
+// budget. A budget of 0 searches to max_depth with no clock, and the move
+// then depends only on the position.
+int ai_choose_move(AiSearch* search, const VariantState* state, int roll, int budget_ms, AiResult* result) {
+    AiMove moves[DICE_SIDES * AI_MAX_TOKENS];
+    int count = variant_legal_moves(search->board, &search->rules, state, roll, moves);
+    double deadline = budget_ms > 0 ? now_seconds() + budget_ms / 1000.0 : INFINITY;
+
+    memset(result, 0, sizeof(*result));
+    result->move = moves[0];
+    if (state->winner >= 0) return 0;
+    search->ai_player = state->current;
+    search->nodes = 0;
+    if (count == 1) return 1;
+
+    // Without a clock the shallower iterations would only be thrown away
+    for (int depth = budget_ms > 0 ? 1 : search->max_depth; depth <= search->max_depth; depth++) {
+        AiMove best_move = moves[0];
+        double best = -INFINITY;
+
+        search->aborted = 0;
+        search->deadline = result->depth == 0 ? INFINITY : deadline;
+        for (int i = 0; i < count && !search->aborted; i++) {
+            VariantState next = *state;
+            variant_apply(search->board, &search->rules, &next, moves[i]);
+            double value = chance_value(search, &next, depth - 1);
+            if (value > best) {
+                best = value;
+                best_move = moves[i];
+            }
+        }
+        if (search->aborted) break;
+
+        result->move = best_move;
+        result->value = best;
+        result->depth = depth;
+        if (fabs(best) >= AI_WIN_SCORE || now_seconds() > deadline) break;
+    }
+    result->nodes = search->nodes;
+    return 1;
+}
@@ -0,0 +1,92 @@
+/*SNAKE & LADDER GAME - EXPECTIMAX COMPUTER OPPONENT*/
+#ifndef SNAKE_LADDER_AI_H
+#define SNAKE_LADDER_AI_H
+
+#include "snake_ladder_core.h"
+
+// Variant games are two-player, with up to this many tokens each
+#define AI_PLAYERS 2
+#define AI_MAX_TOKENS 4
+
+// Search limits: transposition table entries (a power of two), deepest
+// iteration, and how often the clock is read
+#define AI_DEFAULT_TABLE_ENTRIES (1L << 16)
+#define AI_MAX_DEPTH 64
+#define AI_CLOCK_NODES 1024
+
+// Plies after which a variant game is abandoned as unfinished
+#define AI_MAX_PLIES 10000
+
+// Score of a won game, in the evaluation's units of expected turns
+#define AI_WIN_SCORE 10000.0
+
+// Rules of a variant. With every option off this is the original game
+// played with dice.
+typedef struct {
+    int tokens;             // tokens per player; all of them must get home
+    int exact_finish;       // a roll past the last square leaves the token where it is
+    int bonus_six;          // a six that moves a token earns another roll
+    int chosen_rolls;       // players pick their number, as in the SDL game
+} VariantRules;
+
+// Position of a variant game; a token on square `squares` is home
+typedef struct {
+    int current;
+    int winner;             // -1 while the game is in progress
+    int32_t position[AI_PLAYERS][AI_MAX_TOKENS];
+} VariantState;
+
+// One decision: the roll (chosen or thrown) and the token it moves, or -1
+// when no token can move and the turn passes
+typedef struct {
+    int roll;
+    int token;
+} AiMove;
+
+// Transposition table entry: a chance node's value at a search depth. The
+// value is kept at full precision, so a search returns the same result
+// whatever the table held before it.
+typedef struct {
+    uint64_t key;
+    double value;
+    int16_t depth;
+} AiEntry;
+
+// Search state, reused between moves
+typedef struct {
+    const Board* board;
+    VariantRules rules;
+    int ai_player;
+    int max_depth;          // deepest iteration, AI_MAX_DEPTH unless lowered
+    double* token_turns;    // [square] expected turns to bring one token home
+    uint64_t* zobrist;      // [player * (squares + 1) + square]
+    AiEntry* table;
+    long table_mask;
+    long nodes;
+    int aborted;
+    double deadline;        // seconds on the monotonic clock
+} AiSearch;
+
+// What a search found
+typedef struct {
+    AiMove move;
+    double value;
+    int depth;              // deepest iteration completed
+    long nodes;
+} AiResult;
+
+// Variant rules
+void variant_init(VariantState* state);
+int variant_token_target(const Board* board, const VariantRules* rules, const VariantState* state,
+                         int token, int roll);
+int variant_legal_moves(const Board* board, const VariantRules* rules, const VariantState* state,
+                        int roll, AiMove* moves);
+void variant_apply(const Board* board, const VariantRules* rules, VariantState* state, AiMove move);
+
+// Search
+int ai_init(AiSearch* search, const Board* board, const VariantRules* rules, long table_entries);
+void ai_free(AiSearch* search);
+double ai_evaluate(const AiSearch* search, const VariantState* state);
+int ai_choose_move(AiSearch* search, const VariantState* state, int roll, int budget_ms, AiResult* result);
+
+#endif
@@ -0,0 +1,224 @@
+/*SNAKE & LADDER GAME - REPLAY ARCHIVE ANALYTICS*/
+// A replay archive is mapped into memory rather than read, so the page cache
+// is scanned in place and no file is ever copied whole. The archive is cut
+// into fixed byte ranges with no pass over it first; the worker of a range
+// finds the first record starting in it on its own and replays every record
+// that starts there, through the same game_take_turn() rules the GUI plays
+// with, into its own statistics. Afterwards the ranges are checked to chain
+// into one unbroken sequence of records, which is how corruption is found.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "snake_ladder_analytics.h"
+#include "snake_ladder_runner.h"
+
+// Per-run state of a parallel scan
+typedef struct {
+    const uint8_t* data;
+    size_t size;
+    size_t* first_record;               // [chunk] = first record start, or the range end
+    size_t* chain_end;                  // [chunk] = where its last record ends
+    const Board* board;
+    uint64_t hash;
+    ReplayStats* worker_stats;
+} AnalyticsJob;
+
+// Set up empty statistics for games on a board
+int replay_stats_init(ReplayStats* stats, const Board* board) {
+    memset(stats, 0, sizeof(*stats));
+    stats->squares = board->squares;
+    stats->snake_hits = calloc(board->squares, sizeof(long));
+    stats->ladder_hits = calloc(board->squares, sizeof(long));
+    if (stats->snake_hits == NULL || stats->ladder_hits == NULL) {
+        printf("Out of memory for replay statistics!\n");
+        replay_stats_free(stats);
+        return 0;
+    }
+    return 1;
+}
+
+// Release the per-square counters
+void replay_stats_free(ReplayStats* stats) {
+    free(stats->snake_hits);
+    free(stats->ladder_hits);
+    stats->snake_hits = NULL;
+    stats->ladder_hits = NULL;
+}
+
+// Add one set of replay statistics into another
+void replay_stats_merge(ReplayStats* total, const ReplayStats* part) {
+    total->games += part->games;
+    total->other_board += part->other_board;
+    total->unfinished += part->unfinished;
+    total->total_turns += part->total_turns;
+    total->lost_turns += part->lost_turns;
+    total->bytes += part->bytes;
+    for (int t = 0; t <= MAX_TRACKED_TURNS; t++) {
+        total->length_hist[t] += part->length_hist[t];
+    }
+    for (int p = 0; p < MAX_PLAYERS; p++) {
+        total->wins[p] += part->wins[p];
+    }
+    for (int n = 0; n <= MAX_PLAYERS; n++) {
+        total->games_by_players[n] += part->games_by_players[n];
+        total->finished_by_players[n] += part->finished_by_players[n];
+    }
+    for (int square = 0; square < total->squares; square++) {
+        total->snake_hits[square] += part->snake_hits[square];
+        total->ladder_hits[square] += part->ladder_hits[square];
+    }
+}
+
+// Replay one recorded game into the statistics; hash is the board's hash
+void analyze_record(const ReplayRecord* record, const Board* board, uint64_t hash, ReplayStats* stats) {
+    const ReplayHeader* header = &record->header;
+    TurnResult turn;
+    Game game;
+
+    stats->bytes += record->size;
+    if (header->board_hash != hash) {
+        stats->other_board++;
+        return;
+    }
+
+    // Rolls are decoded in order through a bit buffer rather than one
+    // replay_roll() lookup per turn
+    const uint8_t* next_byte = record->rolls;
+    unsigned bits = 0;
+    int available = 0;
+
+    game_init(&game, header->num_players);
+    for (uint32_t t = 0; t < header->num_turns && game.winner < 0; t++) {
+        if (available < REPLAY_ROLL_BITS) {
+            bits |= (unsigned)*next_byte++ << available;
+            available += 8;
+        }
+        int roll = (int)(bits & ((1u << REPLAY_ROLL_BITS) - 1));
+        bits >>= REPLAY_ROLL_BITS;
+        available -= REPLAY_ROLL_BITS;
+
+        game_take_turn(&game, board, roll, &turn);
+        if (!turn.valid) stats->lost_turns++;
+        else if (turn.jump == JUMP_SNAKE) stats->snake_hits[turn.landed]++;
+        else if (turn.jump == JUMP_LADDER) stats->ladder_hits[turn.landed]++;
+    }
+
+    stats->games++;
+    stats->games_by_players[header->num_players]++;
+    stats->total_turns += game.turns;
+    if (game.winner < 0) {
+        stats->unfinished++;
+        return;
+    }
+    stats->wins[game.winner]++;
+    stats->finished_by_players[header->num_players]++;
+    stats->length_hist[game.turns < MAX_TRACKED_TURNS ? game.turns : MAX_TRACKED_TURNS]++;
+}
+
+// Whether a record starts at an offset: its header must parse and be
+// followed by another record or the end of the archive, so that bytes inside
+// a record's rolls are not mistaken for a header
+static int record_starts_at(const uint8_t* data, size_t size, size_t offset) {
+    ReplayRecord record;
+    if (!replay_parse(data + offset, size - offset, &record)) return 0;
+    offset += record.size;
+    return offset == size || replay_parse(data + offset, size - offset, &record);
+}
+
+// Replay the records starting in one byte range into the worker's own
+// statistics, first resynchronizing on the first aligned record header
+static void analyze_chunk(void* context, int worker, long chunk) {
+    AnalyticsJob* job = context;
+    size_t offset = (size_t)chunk * ANALYTICS_CHUNK_BYTES;
+    size_t end = offset + ANALYTICS_CHUNK_BYTES < job->size ? offset + ANALYTICS_CHUNK_BYTES : job->size;
+    ReplayRecord record;
+
+    while (offset < end && !record_starts_at(job->data, job->size, offset)) offset += REPLAY_ALIGNMENT;
+    job->first_record[chunk] = offset;
+
+    // The last record may run on into the next ranges
+    while (offset < end && replay_parse(job->data + offset, job->size - offset, &record)) {
+        analyze_record(&record, job->board, job->hash, &job->worker_stats[worker]);
+        offset += record.size;
+    }
+    job->chain_end[chunk] = offset;
+}
+
+// Check that the ranges' records follow on from each other to the end of
+// the archive; a range with no record must lie inside the one before it
+static int check_chain(const AnalyticsJob* job, long chunks) {
+    size_t expected = 0;
+
+    for (long chunk = 0; chunk < chunks; chunk++) {
+        size_t end = (size_t)(chunk + 1) * ANALYTICS_CHUNK_BYTES;
+        if (end > job->size) end = job->size;
+        if (job->first_record[chunk] == end && expected >= end) continue;
+        if (job->first_record[chunk] != expected) break;
+        expected = job->chain_end[chunk];
+    }
+    if (expected != job->size) {
+        printf("Corrupt replay record at byte %zu!\n", expected);
+        return 0;
+    }
+    return 1;
+}
+
+// Scan a replay archive on all threads and add its games to stats, which
+// must have been set up for the same board
+int analyze_replay_file(const char* path, const Board* board, int threads, ReplayStats* stats) {
+    struct stat info;
+    int fd = open(path, O_RDONLY);
+    if (fd < 0 || fstat(fd, &info) != 0) {
+        printf("Could not open %s!\n", path);
+        if (fd >= 0) close(fd);
+        return 0;
+    }
+    if (info.st_size == 0) {
+        close(fd);
+        return 1;
+    }
+
+    size_t size = (size_t)info.st_size;
+    const uint8_t* data = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        printf("Could not map %s!\n", path);
+        return 0;
+    }
+    madvise((void*)data, size, MADV_SEQUENTIAL);
+
+    if (threads < 1) threads = 1;
+    if (threads > RUNNER_MAX_THREADS) threads = RUNNER_MAX_THREADS;
+
+    long chunks = (long)((size + ANALYTICS_CHUNK_BYTES - 1) / ANALYTICS_CHUNK_BYTES);
+    size_t* first_record = malloc(sizeof(size_t) * chunks);
+    size_t* chain_end = malloc(sizeof(size_t) * chunks);
+    ReplayStats* worker_stats = calloc(threads, sizeof(ReplayStats));
+    int ok = first_record != NULL && chain_end != NULL && worker_stats != NULL;
+    if (!ok) printf("Out of memory in replay analytics!\n");
+
+    int initialized = 0;
+    while (ok && initialized < threads) {
+        ok = replay_stats_init(&worker_stats[initialized], board);
+        if (ok) initialized++;
+    }
+
+    if (ok) {
+        AnalyticsJob job = {data, size, first_record, chain_end, board, board_hash(board), worker_stats};
+        ok = run_parallel_chunks(chunks, threads, analyze_chunk, &job) && check_chain(&job, chunks);
+    }
+
+    for (int i = 0; i < initialized; i++) {
+        if (ok) replay_stats_merge(stats, &worker_stats[i]);
+        replay_stats_free(&worker_stats[i]);
+    }
+    free(worker_stats);
+    free(first_record);
+    free(chain_end);
+    munmap((void*)data, size);
+    return ok;
+}
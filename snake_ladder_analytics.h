@@ -0,0 +1,35 @@
+/*SNAKE & LADDER GAME - REPLAY ARCHIVE ANALYTICS*/
+#ifndef SNAKE_LADDER_ANALYTICS_H
+#define SNAKE_LADDER_ANALYTICS_H
+
+#include "snake_ladder_core.h"
+#include "snake_ladder_replay.h"
+
+// Bytes of the archive handed to a worker at a time (a multiple of
+// REPLAY_ALIGNMENT, so every range starts on a possible record boundary)
+#define ANALYTICS_CHUNK_BYTES (4L << 20)
+
+// Aggregate statistics of the games in a replay archive
+typedef struct {
+    int squares;
+    long games;                         // games played on the analyzed board
+    long other_board;                   // records of other boards, skipped
+    long unfinished;                    // games recorded without a winner
+    long total_turns;
+    long lost_turns;
+    long length_hist[MAX_TRACKED_TURNS + 1];
+    long wins[MAX_PLAYERS];
+    long games_by_players[MAX_PLAYERS + 1];
+    long finished_by_players[MAX_PLAYERS + 1];
+    long* snake_hits;                   // [square] = times a piece landed on its snake
+    long* ladder_hits;                  // [square] = times a piece landed on its ladder
+    size_t bytes;
+} ReplayStats;
+
+int replay_stats_init(ReplayStats* stats, const Board* board);
+void replay_stats_free(ReplayStats* stats);
+void replay_stats_merge(ReplayStats* total, const ReplayStats* part);
+void analyze_record(const ReplayRecord* record, const Board* board, uint64_t hash, ReplayStats* stats);
+int analyze_replay_file(const char* path, const Board* board, int threads, ReplayStats* stats);
+
+#endif
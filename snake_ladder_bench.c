@@ -0,0 +1,220 @@
+/*SNAKE & LADDER GAME - BENCHMARK SUITE*/
+// Build: cc -O2 -pthread -o snake_ladder_bench snake_ladder_bench.c snake_ladder_core.c snake_ladder_policy.c snake_ladder_ai.c snake_ladder_runner.c snake_ladder_lockstep.c -lSDL2 -lSDL2_ttf -lm
+// Usage: ./snake_ladder_bench [output file]
+//
+// Prints one JSON object per line, so results can be appended to a file and
+// compared between releases. The SDL game is compiled into this program with
+// its main() left out, so the real drawing code is what gets measured.
+#define SNAKE_LADDER_NO_MAIN
+#include "snake_ladder_modern.c"
+#include "snake_ladder_runner.h"
+#include "snake_ladder_lockstep.h"
+
+// Benchmark sizes
+#define BENCH_GAMES 2000000
+#define BENCH_TEXT_CALLS 20000
+#define BENCH_FRAMES 500
+#define BENCH_SEED 12345
+#define BENCH_FLOW_GAMES 200000
+
+// Renderer configurations the drawing benchmarks run under
+typedef struct {
+    const char* video_driver;   // NULL keeps SDL's default
+    const char* render_driver;
+    int headless;               // draw into an offscreen surface, no window
+} RenderConfig;
+
+FILE* bench_output = NULL;
+
+// The caller's SDL_VIDEODRIVER, or NULL if it was not set
+char* saved_video_driver = NULL;
+
+// Seconds elapsed since a performance-counter reading
+static double seconds_since(Uint64 start) {
+    return (double)(SDL_GetPerformanceCounter() - start) / SDL_GetPerformanceFrequency();
+}
+
+// Write one result record
+static void report(const char* benchmark, const char* config, long iterations, double seconds,
+                   const char* unit, double value) {
+    fprintf(bench_output,
+            "{\"benchmark\":\"%s\",\"config\":\"%s\",\"iterations\":%ld,"
+            "\"seconds\":%.6f,\"%s\":%.3f}\n",
+            benchmark, config, iterations, seconds, unit, value);
+    fflush(bench_output);
+}
+
+// Write a record for a configuration that could not run
+static void report_failure(const char* benchmark, const char* config, const char* error) {
+    fprintf(bench_output, "{\"benchmark\":\"%s\",\"config\":\"%s\",\"error\":\"%s\"}\n",
+            benchmark, config, error);
+    fflush(bench_output);
+}
+
+// Games per second of the game logic behind play_game()
+static void bench_game_logic() {
+    SimConfig config = {&board, DEFAULT_PLAYERS, BENCH_SEED};
+
+    struct {
+        const char* name;
+        GameRangeFunction simulate_range;
+        int threads;
+    } runs[] = {
+        {"scalar", simulate_game_range, 1},
+        {"lockstep", lockstep_simulate_range, 1},
+        {"lockstep_all_threads", lockstep_simulate_range, runner_default_threads()},
+    };
+
+    for (size_t i = 0; i < sizeof(runs) / sizeof(runs[0]); i++) {
+        SimStats stats;
+        sim_stats_reset(&stats);
+
+        Uint64 start = SDL_GetPerformanceCounter();
+        run_parallel_simulation(&config, BENCH_GAMES, runs[i].threads, runs[i].simulate_range, &stats);
+        double seconds = seconds_since(start);
+
+        report("game_logic", runs[i].name, stats.games, seconds, "games_per_second",
+               stats.games / seconds);
+    }
+}
+
+// Cost of suspending and resuming a turn flow, the coroutine play_game()
+// and the server drive, measured over whole games
+static void bench_turn_flow() {
+    DiceSource dice;
+    TurnFlow flow;
+    long resumes = 0;
+
+    dice_seed(&dice, BENCH_SEED);
+    Uint64 start = SDL_GetPerformanceCounter();
+    for (int i = 0; i < BENCH_FLOW_GAMES; i++) {
+        turn_flow_init(&flow, DEFAULT_PLAYERS);
+        TurnEvent event = turn_flow_resume(&flow, &board, 0);
+        while (event != TURN_GAME_OVER) {
+            event = turn_flow_resume(&flow, &board, event == TURN_NEED_ROLL ? dice_roll(&dice) : 0);
+            resumes++;
+        }
+    }
+    double seconds = seconds_since(start);
+
+    report("turn_flow", "resume", resumes, seconds, "ns_per_resume", seconds * 1e9 / resumes);
+}
+
+// Per-call cost of draw_text(), including the flush at the end
+static void bench_draw_text(const char* config) {
+    set_background_color(COLOR_BLUE);
+    clear_screen();
+
+    Uint64 start = SDL_GetPerformanceCounter();
+    for (int i = 0; i < BENCH_TEXT_CALLS; i++) {
+        draw_text(320, 230, "1.WANT TO PLAY", COLOR_WHITE);
+    }
+    SDL_RenderPresent(renderer);
+    double seconds = seconds_since(start);
+
+    report("draw_text", config, BENCH_TEXT_CALLS, seconds, "ns_per_call",
+           seconds * 1e9 / BENCH_TEXT_CALLS);
+}
+
+// Per-frame cost of the board: one token move repainted incrementally, and a
+// full redraw without the cached texture
+static void bench_draw_board(const char* config) {
+    int32_t positions[MAX_PLAYERS] = {0};
+
+    // First frame builds the cached board texture
+    draw_board();
+
+    reset_render_stats();
+    Uint64 start = SDL_GetPerformanceCounter();
+    for (int i = 0; i < BENCH_FRAMES; i++) {
+        positions[i % num_players] = 1 + i % (board.squares - 1);
+        draw_game_frame(positions, 0, "PLAYER A: PRESS 1-6");
+    }
+    double seconds = seconds_since(start);
+    report("draw_board", config, BENCH_FRAMES, seconds, "us_per_frame", seconds * 1e6 / BENCH_FRAMES);
+    report("draw_board_calls", config, BENCH_FRAMES, seconds, "draw_calls_per_frame",
+           render_stats.draw_calls.total / BENCH_FRAMES);
+
+    start = SDL_GetPerformanceCounter();
+    for (int i = 0; i < BENCH_FRAMES; i++) {
+        draw_board_static();
+        SDL_RenderPresent(renderer);
+    }
+    seconds = seconds_since(start);
+    report("draw_board_uncached", config, BENCH_FRAMES, seconds, "us_per_frame",
+           seconds * 1e6 / BENCH_FRAMES);
+}
+
+// Put SDL_VIDEODRIVER back the way the caller had it, since a config or a
+// headless init_graphics() may have set it
+static void restore_video_driver() {
+    if (saved_video_driver) SDL_setenv("SDL_VIDEODRIVER", saved_video_driver, 1);
+    else unsetenv("SDL_VIDEODRIVER");
+}
+
+// Start-up time plus drawing benchmarks under one renderer configuration
+static void bench_render_config(const RenderConfig* rc) {
+    char config[64];
+    snprintf(config, sizeof(config), "%s/%s",
+             rc->headless ? "offscreen" : rc->video_driver ? rc->video_driver : "default",
+             rc->render_driver);
+
+    if (rc->video_driver) SDL_setenv("SDL_VIDEODRIVER", rc->video_driver, 1);
+    else restore_video_driver();
+    SDL_SetHint(SDL_HINT_RENDER_DRIVER, rc->render_driver);
+
+    headless = rc->headless;
+    Uint64 start = SDL_GetPerformanceCounter();
+    int ok = init_graphics();
+    double seconds = seconds_since(start);
+    restore_video_driver();
+
+    if (!ok) {
+        report_failure("init_graphics", config, SDL_GetError());
+        cleanup_graphics();
+        headless = 0;
+        return;
+    }
+    report("init_graphics", config, 1, seconds, "ms", seconds * 1e3);
+
+    bench_draw_text(config);
+    bench_draw_board(config);
+    cleanup_graphics();
+    headless = 0;
+}
+
+// Main function
+int main(int argc, char** argv) {
+    RenderConfig configs[] = {
+        {"dummy", "software", 0},
+        {NULL, "software", 0},
+        {NULL, "software", 1},
+    };
+
+    const char* video_driver = SDL_getenv("SDL_VIDEODRIVER");
+    if (video_driver) saved_video_driver = strdup(video_driver);
+
+    bench_output = stdout;
+    if (argc > 1) {
+        bench_output = fopen(argv[1], "a");
+        if (bench_output == NULL) {
+            printf("Could not open %s!\n", argv[1]);
+            return 1;
+        }
+    }
+
+    if (!board_init_classic(&board) || !build_board_layout(&layout, &board, BOARD_WIDTH, BOARD_HEIGHT)) {
+        return 1;
+    }
+    bench_game_logic();
+    bench_turn_flow();
+    for (size_t i = 0; i < sizeof(configs) / sizeof(configs[0]); i++) {
+        bench_render_config(&configs[i]);
+    }
+
+    free_board_layout(&layout);
+    board_free(&board);
+    if (bench_output != stdout) fclose(bench_output);
+    free(saved_video_driver);
+    return 0;
+}
@@ -0,0 +1,461 @@
+/*SNAKE & LADDER GAME - HEADLESS GAME CORE*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "snake_ladder_core.h"
+
+#define FNV_OFFSET_BASIS 0xCBF29CE484222325ULL
+#define FNV_PRIME 0x100000001B3ULL
+
+// Philox4x32-10 multipliers and key schedule (Salmon et al., SC'11)
+#define PHILOX_M0 0xD2511F53u
+#define PHILOX_M1 0xCD9E8D57u
+#define PHILOX_W0 0x9E3779B9u
+#define PHILOX_W1 0xBB67AE85u
+#define PHILOX_ROUNDS 10
+
+// Each 32-bit word of a block gives six rolls, the first six base-6 digits
+// of the word read as a fraction. Words are accepted by Lemire's
+// multiply-and-reject test for the range 6^6: a word is rejected (about 1
+// in 1.7 million) when the low half of word * 6^6 falls under 2^32 mod 6^6.
+// What remains maps onto every six-roll sequence equally often.
+#define DICE_ROLLS_PER_WORD 6
+#define DICE_WORD_RANGE (DICE_SIDES * DICE_SIDES * DICE_SIDES * DICE_SIDES * DICE_SIDES * DICE_SIDES)
+#define DICE_REJECT_BELOW (0x100000000ULL % DICE_WORD_RANGE)
+#define DICE_ROLLS_PER_BLOCK (4 * DICE_ROLLS_PER_WORD)
+#define DICE_BLOCKS (DICE_BUFFER_ROLLS / DICE_ROLLS_PER_BLOCK)
+
+_Static_assert(DICE_BLOCKS == 2, "dice_refill encrypts two blocks per refill");
+
+// Coroutine helpers for turn flows: a yield records where to continue and
+// returns, and the switch jumps back there on the next resume
+#define FLOW_BEGIN(flow) switch ((flow)->resume) { case 0:
+#define FLOW_YIELD(flow, value) do { \
+        (flow)->resume = __LINE__; \
+        return (flow)->event = (value); \
+        case __LINE__:; \
+    } while (0)
+#define FLOW_END }
+
+// Snakes and ladders of the original game, as (from, to) pairs
+static const int classic_jumps[][2] = {
+    {60, 30}, {94, 1}, {82, 17}, {36, 7}, {99, 3}, {97, 32},    // Snakes
+    {27, 98}, {43, 66}, {7, 77}, {33, 85}, {49, 93}, {14, 61}   // Ladders
+};
+
+// Allocate an empty rows x cols board
+int board_init(Board* board, int rows, int cols) {
+    memset(board, 0, sizeof(*board));
+    if (rows < 1 || cols < 1 || (long)rows * cols < 2 || (long)rows * cols > MAX_BOARD_SQUARES) {
+        printf("Invalid board size %d x %d!\n", rows, cols);
+        return 0;
+    }
+
+    board->rows = rows;
+    board->cols = cols;
+    board->squares = rows * cols;
+    board->dest = malloc(sizeof(int32_t) * (board->squares + DICE_SIDES));
+    board->kind = malloc(board->squares + DICE_SIDES);
+    if (board->dest == NULL || board->kind == NULL) {
+        printf("Out of memory for a %d x %d board!\n", rows, cols);
+        board_free(board);
+        return 0;
+    }
+
+    board_clear(board);
+    return 1;
+}
+
+// Release a board's jump table
+void board_free(Board* board) {
+    free(board->dest);
+    free(board->kind);
+    board->dest = NULL;
+    board->kind = NULL;
+}
+
+// Reset a board to plain squares with no snakes or ladders
+void board_clear(Board* board) {
+    for (int square = 0; square < board->squares + DICE_SIDES; square++) {
+        board->dest[square] = square;
+    }
+    memset(board->kind, JUMP_NONE, board->squares + DICE_SIDES);
+}
+
+// Place a snake (to < from) or ladder (to > from) on the board
+int board_add_jump(Board* board, int from, int to) {
+    if (from < 1 || from >= board->squares || to < 1 || to > board->squares || from == to) {
+        printf("Invalid snake or ladder %d -> %d!\n", from, to);
+        return 0;
+    }
+    if (board->kind[from] != JUMP_NONE) {
+        printf("Square %d already has a snake or ladder!\n", from);
+        return 0;
+    }
+
+    board->dest[from] = to;
+    board->kind[from] = to < from ? JUMP_SNAKE : JUMP_LADDER;
+    return 1;
+}
+
+// Build the board of the original game
+int board_init_classic(Board* board) {
+    if (!board_init(board, BOARD_ROWS, BOARD_COLS)) return 0;
+
+    for (size_t i = 0; i < sizeof(classic_jumps) / sizeof(classic_jumps[0]); i++) {
+        board_add_jump(board, classic_jumps[i][0], classic_jumps[i][1]);
+    }
+    return 1;
+}
+
+// Load a board file: an optional "size rows cols" line (default 10 x 10)
+// followed by one "from to" pair per line; '#' starts a comment
+int board_load(Board* board, const char* path) {
+    FILE* file = fopen(path, "r");
+    if (file == NULL) {
+        printf("Could not open board file %s!\n", path);
+        memset(board, 0, sizeof(*board));
+        return 0;
+    }
+
+    char line[256];
+    int line_number = 0;
+    int jumps = 0;
+    int ok = board_init(board, BOARD_ROWS, BOARD_COLS);
+
+    while (ok && fgets(line, sizeof(line), file)) {
+        int from, to, rows, cols;
+        char extra;
+
+        line_number++;
+        char* comment = strchr(line, '#');
+        if (comment) *comment = '\0';
+        if (strspn(line, " \t\r\n") == strlen(line)) continue;
+
+        if (sscanf(line, " size %d %d %c", &rows, &cols, &extra) == 2) {
+            if (jumps > 0) {
+                printf("%s:%d: the board size must come before any snake or ladder\n",
+                       path, line_number);
+                ok = 0;
+            } else {
+                board_free(board);
+                ok = board_init(board, rows, cols);
+            }
+        } else if (sscanf(line, "%d %d %c", &from, &to, &extra) == 2) {
+            ok = board_add_jump(board, from, to);
+            jumps++;
+        } else {
+            printf("%s:%d: expected \"from to\" or \"size rows cols\"\n", path, line_number);
+            ok = 0;
+        }
+    }
+
+    fclose(file);
+    if (!ok) board_free(board);
+    return ok;
+}
+
+// Write a board file that board_load() reads back, led by an optional
+// comment line
+int board_save(const Board* board, const char* path, const char* comment) {
+    FILE* file = fopen(path, "w");
+    if (file == NULL) {
+        printf("Could not create board file %s!\n", path);
+        return 0;
+    }
+
+    fprintf(file, "# Snake & Ladder board\n");
+    if (comment) fprintf(file, "# %s\n", comment);
+    fprintf(file, "size %d %d\n", board->rows, board->cols);
+
+    for (int pass = JUMP_SNAKE; pass <= JUMP_LADDER; pass++) {
+        fprintf(file, "\n# %s\n", pass == JUMP_SNAKE ? "Snakes" : "Ladders");
+        for (int square = 1; square < board->squares; square++) {
+            if (board->kind[square] == pass) fprintf(file, "%d %d\n", square, board->dest[square]);
+        }
+    }
+
+    int ok = fclose(file) == 0;
+    if (!ok) printf("Could not write board file %s!\n", path);
+    return ok;
+}
+
+// FNV-1a hash of a board's size and jump table, identifying the board a
+// recorded game was played on
+uint64_t board_hash(const Board* board) {
+    uint64_t hash = FNV_OFFSET_BASIS;
+    int32_t fields[2] = {board->rows, board->cols};
+    const uint8_t* bytes = (const uint8_t*)fields;
+
+    for (size_t i = 0; i < sizeof(fields); i++) {
+        hash = (hash ^ bytes[i]) * FNV_PRIME;
+    }
+    bytes = (const uint8_t*)board->dest;
+    for (size_t i = 0; i < sizeof(int32_t) * board->squares; i++) {
+        hash = (hash ^ bytes[i]) * FNV_PRIME;
+    }
+    return hash;
+}
+
+// Start a new game with every player off the board
+void game_init(Game* game, int num_players) {
+    memset(game, 0, sizeof(*game));
+    game->num_players = num_players;
+    game->winner = -1;
+}
+
+// Play one turn for the current player
+void game_take_turn(Game* game, const Board* board, int roll, TurnResult* result) {
+    int player = game->current;
+
+    result->player = player;
+    result->roll = roll;
+    result->valid = roll >= 1 && roll <= DICE_SIDES;
+    result->landed = game->position[player];
+    result->position = game->position[player];
+    result->jump = JUMP_NONE;
+
+    // A roll outside 1-6 loses the chance, as in the original game
+    if (result->valid) {
+        result->landed += roll;
+        result->position = board_jump(board, result->landed);
+        result->jump = (JumpKind)board->kind[result->landed];
+        game->position[player] = result->position;
+
+        if (result->position >= board->squares) {
+            game->winner = player;
+        }
+    }
+
+    game->turns++;
+    game->current = player + 1 < game->num_players ? player + 1 : 0;
+}
+
+// Start a turn flow for a new game; the first resume asks for a roll
+void turn_flow_init(TurnFlow* flow, int num_players) {
+    memset(flow, 0, sizeof(*flow));
+    game_init(&flow->game, num_players);
+}
+
+// Run a game's turns until the next roll is needed or something happened
+// that the caller shows; roll is only read when resuming from TURN_NEED_ROLL
+TurnEvent turn_flow_resume(TurnFlow* flow, const Board* board, int roll) {
+    FLOW_BEGIN(flow);
+
+    while (flow->game.winner < 0) {
+        FLOW_YIELD(flow, TURN_NEED_ROLL);
+        game_take_turn(&flow->game, board, roll, &flow->turn);
+
+        if (!flow->turn.valid) {
+            FLOW_YIELD(flow, TURN_LOST);
+            continue;
+        }
+        if (flow->turn.jump != JUMP_NONE) FLOW_YIELD(flow, TURN_LANDED);
+        FLOW_YIELD(flow, TURN_MOVED);
+    }
+
+    while (1) FLOW_YIELD(flow, TURN_GAME_OVER);
+
+    FLOW_END;
+    return flow->event;
+}
+
+// SplitMix64 finalizer
+static uint64_t mix64(uint64_t z) {
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+// One Philox round on a 128-bit counter
+static inline void philox_round(uint32_t c[4], uint32_t k0, uint32_t k1) {
+    uint64_t p0 = (uint64_t)PHILOX_M0 * c[0];
+    uint64_t p1 = (uint64_t)PHILOX_M1 * c[2];
+    c[0] = (uint32_t)(p1 >> 32) ^ c[1] ^ k0;
+    c[2] = (uint32_t)(p0 >> 32) ^ c[3] ^ k1;
+    c[1] = (uint32_t)p1;
+    c[3] = (uint32_t)p0;
+}
+
+// Philox4x32-10: encrypt a 128-bit counter under a 64-bit key, in place
+static inline void philox4x32(uint32_t c[4], const uint32_t key[2]) {
+    uint32_t k0 = key[0], k1 = key[1];
+
+    for (int round = 0; round < PHILOX_ROUNDS; round++) {
+        philox_round(c, k0, k1);
+        k0 += PHILOX_W0;
+        k1 += PHILOX_W1;
+    }
+}
+
+// Load the counter of a block: the block number, then the attempt
+static inline void philox_counter(uint32_t c[4], uint64_t block, uint32_t attempt) {
+    c[0] = (uint32_t)block;
+    c[1] = (uint32_t)(block >> 32);
+    c[2] = attempt;
+    c[3] = 0;
+}
+
+// Whether a word gives six unbiased rolls
+static inline int dice_word_accepted(uint32_t bits) {
+    return (uint32_t)((uint64_t)bits * DICE_WORD_RANGE) >= DICE_REJECT_BELOW;
+}
+
+// Replace a rejected word of block `block`, drawing it again from retry
+// blocks (the counter's third word numbers the attempt) until accepted
+static uint32_t dice_redraw_word(const uint32_t key[2], uint64_t block, int word, uint32_t bits) {
+    for (uint32_t attempt = 1; !dice_word_accepted(bits); attempt++) {
+        uint32_t c[4];
+        philox_counter(c, block, attempt);
+        philox4x32(c, key);
+        bits = c[word];
+    }
+    return bits;
+}
+
+// Read an accepted word's six base-6 digits as rolls, most significant
+// first. Digit i is the high half of six times the fraction left after the
+// first i digits, which is the word times 6^i modulo 2^32, so the digits do
+// not wait on each other.
+static inline void dice_unpack(uint32_t bits, uint8_t* rolls) {
+    uint32_t scale = 1;
+    for (int i = 0; i < DICE_ROLLS_PER_WORD; i++, scale *= DICE_SIDES) {
+        rolls[i] = (uint8_t)(1 + (((uint64_t)(uint32_t)(bits * scale) * DICE_SIDES) >> 32));
+    }
+}
+
+// Write the rolls of an encrypted block
+static inline void dice_block_rolls(const uint32_t key[2], uint64_t block, const uint32_t words[4],
+                                    uint8_t* rolls) {
+    for (int w = 0; w < 4; w++, rolls += DICE_ROLLS_PER_WORD) {
+        uint32_t bits = words[w];
+        if (!dice_word_accepted(bits)) bits = dice_redraw_word(key, block, w, bits);
+        dice_unpack(bits, rolls);
+    }
+}
+
+// Refill the buffer from the next two blocks. Their rounds are interleaved
+// so the two multiply chains overlap, and the six digits of each word are
+// found in parallel.
+static void dice_refill(DiceSource* dice) {
+    uint32_t a[4], b[4];
+    uint32_t k0 = dice->key[0], k1 = dice->key[1];
+
+    philox_counter(a, dice->block, 0);
+    philox_counter(b, dice->block + 1, 0);
+    for (int round = 0; round < PHILOX_ROUNDS; round++) {
+        philox_round(a, k0, k1);
+        philox_round(b, k0, k1);
+        k0 += PHILOX_W0;
+        k1 += PHILOX_W1;
+    }
+
+    dice_block_rolls(dice->key, dice->block, a, dice->buffer);
+    dice_block_rolls(dice->key, dice->block + 1, b, dice->buffer + DICE_ROLLS_PER_BLOCK);
+    dice->block += DICE_BLOCKS;
+    dice->used = 0;
+}
+
+// Seed a dice stream; the seed is the Philox key
+void dice_seed(DiceSource* dice, uint64_t seed) {
+    dice->key[0] = (uint32_t)seed;
+    dice->key[1] = (uint32_t)(seed >> 32);
+    dice->block = 0;
+    dice->used = DICE_BUFFER_ROLLS;
+}
+
+// Jump a dice stream to roll number `roll` (0-based) without generating
+// the rolls before it
+void dice_seek(DiceSource* dice, uint64_t roll) {
+    dice->block = roll / DICE_ROLLS_PER_BLOCK;
+    dice->used = DICE_BUFFER_ROLLS;
+    if (roll % DICE_ROLLS_PER_BLOCK) {
+        dice_refill(dice);
+        dice->used = (int)(roll % DICE_ROLLS_PER_BLOCK);
+    }
+}
+
+// Dice seed of one game of a seeded batch
+uint64_t game_seed(uint64_t batch_seed, long game) {
+    return batch_seed ^ mix64((uint64_t)game + 1);
+}
+
+// Roll one die (1-6)
+int dice_roll(DiceSource* dice) {
+    if (dice->used == DICE_BUFFER_ROLLS) dice_refill(dice);
+    return dice->buffer[dice->used++];
+}
+
+// Roll number `roll` (0-based) of the stream with a seed, computed directly
+int dice_roll_at(uint64_t seed, uint64_t roll) {
+    uint32_t key[2] = {(uint32_t)seed, (uint32_t)(seed >> 32)};
+    uint64_t block = roll / DICE_ROLLS_PER_BLOCK;
+    int word = (int)(roll % DICE_ROLLS_PER_BLOCK) / DICE_ROLLS_PER_WORD;
+    uint32_t c[4];
+    uint8_t rolls[DICE_ROLLS_PER_WORD];
+
+    philox_counter(c, block, 0);
+    philox4x32(c, key);
+    dice_unpack(dice_redraw_word(key, block, word, c[word]), rolls);
+    return rolls[roll % DICE_ROLLS_PER_WORD];
+}
+
+// Play one complete game, returning the winner
+int simulate_game(const Board* board, int num_players, DiceSource* dice, int* turns) {
+    int32_t position[MAX_PLAYERS];
+    int player = 0;
+    int count = 0;
+
+    memset(position, 0, sizeof(int32_t) * num_players);
+    while (1) {
+        int square = board_jump(board, position[player] + dice_roll(dice));
+        position[player] = square;
+        count++;
+
+        if (square >= board->squares) {
+            *turns = count;
+            return player;
+        }
+        if (++player == num_players) player = 0;
+    }
+}
+
+// Clear batch statistics
+void sim_stats_reset(SimStats* stats) {
+    memset(stats, 0, sizeof(*stats));
+}
+
+// Add one set of batch statistics into another
+void sim_stats_merge(SimStats* total, const SimStats* part) {
+    total->games += part->games;
+    total->total_turns += part->total_turns;
+    for (int p = 0; p < MAX_PLAYERS; p++) {
+        total->wins[p] += part->wins[p];
+    }
+    for (int t = 0; t <= MAX_TRACKED_TURNS; t++) {
+        total->length_hist[t] += part->length_hist[t];
+    }
+}
+
+// Play games first .. first + count - 1 of a batch. Every game has its own
+// dice stream derived from the seed and its index, so results do not depend
+// on how a batch is split up.
+void simulate_game_range(const SimConfig* config, long first, long count, SimStats* stats) {
+    DiceSource dice;
+    int turns;
+
+    for (long i = first; i < first + count; i++) {
+        dice_seed(&dice, game_seed(config->seed, i));
+        int winner = simulate_game(config->board, config->num_players, &dice, &turns);
+
+        stats->games++;
+        stats->wins[winner]++;
+        stats->total_turns += turns;
+        stats->length_hist[turns < MAX_TRACKED_TURNS ? turns : MAX_TRACKED_TURNS]++;
+    }
+}
+
+// Play a batch of games on the calling thread
+void simulate_games(const SimConfig* config, long count, SimStats* stats) {
+    simulate_game_range(config, 0, count, stats);
+}
@@ -0,0 +1,143 @@
+/*SNAKE & LADDER GAME - HEADLESS GAME CORE*/
+#ifndef SNAKE_LADDER_CORE_H
+#define SNAKE_LADDER_CORE_H
+
+#include <stdint.h>
+
+// Board and rule constants; the original board is 10 x 10
+#define BOARD_ROWS 10
+#define BOARD_COLS 10
+#define BOARD_SQUARES (BOARD_ROWS * BOARD_COLS)
+#define MAX_BOARD_SQUARES (1 << 24)
+#define DICE_SIDES 6
+
+// Player limits; the original game is two players
+#define DEFAULT_PLAYERS 2
+#define MAX_PLAYERS 64
+
+// Longest game length tracked individually in simulation histograms
+#define MAX_TRACKED_TURNS 512
+
+// What a square does to a piece that lands on it
+typedef enum {
+    JUMP_NONE = 0,
+    JUMP_SNAKE,
+    JUMP_LADDER
+} JumpKind;
+
+// Board as a flat jump table: one destination and one kind per square.
+// Squares past the end (overshooting rolls) map to themselves so a move is
+// always a single indexed load. Reaching square `squares` or beyond wins.
+typedef struct {
+    int rows;
+    int cols;
+    int squares;
+    int32_t* dest;      // squares + DICE_SIDES entries
+    uint8_t* kind;      // squares + DICE_SIDES entries
+} Board;
+
+// Rolls generated per refill of a dice stream's buffer, a multiple of the
+// 24 rolls of one Philox block
+#define DICE_BUFFER_ROLLS 48
+
+// Seeded dice stream on the Philox4x32-10 counter-based generator. Roll i
+// of a stream is computed from the key and i alone, so a stream can start
+// at any roll and two streams never share state. Rolls are made in bulk
+// into the buffer.
+typedef struct {
+    uint32_t key[2];
+    uint64_t block;                     // Philox block of the next refill
+    int used;                           // rolls of the buffer already taken
+    uint8_t buffer[DICE_BUFFER_ROLLS];
+} DiceSource;
+
+// State of one game in progress. Player state is kept as parallel arrays
+// indexed by player, so every player is advanced by the same turn routine.
+typedef struct {
+    int num_players;
+    int current;    // index of the player to move
+    int winner;     // -1 while the game is in progress
+    int turns;      // turns taken so far, by all players
+    int32_t position[MAX_PLAYERS];
+} Game;
+
+// What happened during a single turn
+typedef struct {
+    int player;
+    int roll;
+    int valid;      // 0 when the roll was outside 1-6 and the turn was lost
+    int landed;     // square reached by the roll
+    int position;   // square after any snake or ladder
+    JumpKind jump;
+} TurnResult;
+
+// Why a turn flow suspended: what it is waiting for or reporting
+typedef enum {
+    TURN_NEED_ROLL,     // resume with the current player's roll
+    TURN_LOST,          // the roll was outside 1-6 and the turn was lost
+    TURN_LANDED,        // the piece landed on a snake or ladder
+    TURN_MOVED,         // the turn is complete
+    TURN_GAME_OVER      // game.winner has won; resuming changes nothing
+} TurnEvent;
+
+// A game's turn sequence as a resumable coroutine: it runs until it needs a
+// roll or has something to report, then returns to the caller. All of its
+// state is in this struct, so any number of games can wait on one thread.
+typedef struct {
+    Game game;
+    TurnResult turn;    // the turn being reported
+    TurnEvent event;    // why the flow last suspended
+    int resume;         // where the flow continues
+} TurnFlow;
+
+// What a batch of simulated games is played with
+typedef struct {
+    const Board* board;
+    int num_players;
+    uint64_t seed;
+} SimConfig;
+
+// Aggregate results of a batch of simulated games
+typedef struct {
+    long games;
+    long wins[MAX_PLAYERS];
+    long total_turns;
+    long length_hist[MAX_TRACKED_TURNS + 1];  // last bucket collects longer games
+} SimStats;
+
+// Board
+int board_init(Board* board, int rows, int cols);
+void board_free(Board* board);
+void board_clear(Board* board);
+int board_add_jump(Board* board, int from, int to);
+int board_init_classic(Board* board);
+int board_load(Board* board, const char* path);
+int board_save(const Board* board, const char* path, const char* comment);
+uint64_t board_hash(const Board* board);
+
+// Look up where a piece landing on a square ends up
+static inline int board_jump(const Board* board, int square) {
+    return board->dest[square];
+}
+
+// Rules
+void game_init(Game* game, int num_players);
+void game_take_turn(Game* game, const Board* board, int roll, TurnResult* result);
+void turn_flow_init(TurnFlow* flow, int num_players);
+TurnEvent turn_flow_resume(TurnFlow* flow, const Board* board, int roll);
+
+// Dice
+void dice_seed(DiceSource* dice, uint64_t seed);
+void dice_seek(DiceSource* dice, uint64_t roll);
+uint64_t game_seed(uint64_t batch_seed, long game);
+int dice_roll(DiceSource* dice);
+int dice_roll_at(uint64_t seed, uint64_t roll);
+
+// Batch simulation
+int simulate_game(const Board* board, int num_players, DiceSource* dice, int* turns);
+void sim_stats_reset(SimStats* stats);
+void sim_stats_merge(SimStats* total, const SimStats* part);
+void simulate_game_range(const SimConfig* config, long first, long count, SimStats* stats);
+void simulate_games(const SimConfig* config, long count, SimStats* stats);
+
+#endif
@@ -0,0 +1,280 @@
+/*SNAKE & LADDER GAME - SERVER LOAD GENERATOR*/
+// Build: cc -O2 -o snake_ladder_loadgen snake_ladder_loadgen.c snake_ladder_core.c
+// Usage: ./snake_ladder_loadgen [--tcp host:port | --unix path] [--sessions N] [--seconds S] [--server-dice] [--seed S]
+//
+// Opens many sessions to snake_ladder_server and plays games on all of them
+// from one epoll loop. Each session has one command in flight at a time, so
+// the time from sending a command to its last reply line is a round trip.
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/resource.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include "snake_ladder_core.h"
+
+#define LOADGEN_DEFAULT_SESSIONS 1000
+#define LOADGEN_DEFAULT_SECONDS 10
+#define LOADGEN_MAX_EVENTS 256
+#define LOADGEN_LINE_MAX 256
+
+// What a client session is waiting for
+typedef enum {
+    WAIT_HELLO,
+    WAIT_TURN,
+    WAIT_WIN,
+    WAIT_NEW
+} ClientState;
+
+// One connection to the server
+typedef struct {
+    int fd;
+    ClientState state;
+    int squares;
+    int in_length;
+    long sent_at;                   // nanoseconds
+    DiceSource dice;
+    char in[LOADGEN_LINE_MAX];
+} Client;
+
+// Global variables
+int epoll_fd = -1;
+int server_dice = 0;
+long turns_played = 0;
+long games_finished = 0;
+long failed_sessions = 0;
+long latency_total = 0;
+long latency_max = 0;
+long round_trips = 0;
+
+// Monotonic clock in nanoseconds
+static long now_ns() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000000L + ts.tv_nsec;
+}
+
+// Send one command line and start timing its round trip
+static int send_command(Client* client, const char* command) {
+    size_t length = strlen(command);
+    client->sent_at = now_ns();
+    return send(client->fd, command, length, MSG_NOSIGNAL) == (ssize_t)length;
+}
+
+// Send the next roll of the client's game
+static int send_roll(Client* client) {
+    char command[16];
+    if (server_dice) return send_command(client, "ROLL\n");
+    snprintf(command, sizeof(command), "%d\n", dice_roll(&client->dice));
+    return send_command(client, command);
+}
+
+// The last reply line of a command arrived
+static void finish_round_trip(Client* client) {
+    long latency = now_ns() - client->sent_at;
+    latency_total += latency;
+    if (latency > latency_max) latency_max = latency;
+    round_trips++;
+}
+
+// React to one reply line; returns 0 if the session should be dropped
+static int handle_line(Client* client, const char* line) {
+    int player, roll, landed, square, players;
+
+    switch (client->state) {
+        case WAIT_HELLO:
+            if (sscanf(line, "HELLO %d %d", &players, &client->squares) != 2) return 0;
+            client->state = WAIT_TURN;
+            return send_roll(client);
+        case WAIT_TURN:
+            turns_played++;
+            if (sscanf(line, "TURN %d %d %d %d", &player, &roll, &landed, &square) == 4 &&
+                square >= client->squares) {
+                client->state = WAIT_WIN;
+                return 1;
+            }
+            if (strncmp(line, "TURN ", 5) != 0 && strncmp(line, "LOST ", 5) != 0) return 0;
+            finish_round_trip(client);
+            return send_roll(client);
+        case WAIT_WIN:
+            if (strncmp(line, "WIN ", 4) != 0) return 0;
+            finish_round_trip(client);
+            games_finished++;
+            client->state = WAIT_NEW;
+            return send_command(client, "NEW\n");
+        case WAIT_NEW:
+            if (strncmp(line, "NEW ", 4) != 0) return 0;
+            finish_round_trip(client);
+            client->state = WAIT_TURN;
+            return send_roll(client);
+    }
+    return 0;
+}
+
+// Read and handle everything the server sent; returns 0 on disconnect
+static int handle_input(Client* client) {
+    while (1) {
+        ssize_t n = recv(client->fd, client->in + client->in_length,
+                         LOADGEN_LINE_MAX - client->in_length, 0);
+        if (n == 0) return 0;
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return errno == EAGAIN || errno == EWOULDBLOCK;
+        }
+        client->in_length += (int)n;
+
+        int start = 0;
+        char* newline;
+        while ((newline = memchr(client->in + start, '\n', client->in_length - start)) != NULL) {
+            *newline = '\0';
+            if (!handle_line(client, client->in + start)) return 0;
+            start = (int)(newline - client->in) + 1;
+        }
+        client->in_length -= start;
+        memmove(client->in, client->in + start, client->in_length);
+        if (client->in_length == LOADGEN_LINE_MAX) return 0;
+    }
+}
+
+// Start a non-blocking connection to the server
+static int connect_client(Client* client, const struct sockaddr* address, socklen_t length) {
+    client->fd = socket(address->sa_family, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (client->fd < 0) return 0;
+
+    int one = 1;
+    if (address->sa_family == AF_INET) setsockopt(client->fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+    if (connect(client->fd, address, length) != 0 && errno != EINPROGRESS) {
+        close(client->fd);
+        client->fd = -1;
+        return 0;
+    }
+
+    struct epoll_event event = {.events = EPOLLIN, .data.ptr = client};
+    return epoll_ctl(epoll_fd, EPOLL_CTL_ADD, client->fd, &event) == 0;
+}
+
+// Drop a session that failed
+static void drop_client(Client* client) {
+    close(client->fd);
+    client->fd = -1;
+    failed_sessions++;
+}
+
+// Main function
+int main(int argc, char** argv) {
+    const char* tcp_arg = "127.0.0.1:7777";
+    const char* unix_path = NULL;
+    int num_sessions = LOADGEN_DEFAULT_SESSIONS;
+    int seconds = LOADGEN_DEFAULT_SECONDS;
+    uint64_t seed = 1;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--tcp") == 0 && i + 1 < argc) {
+            tcp_arg = argv[++i];
+        } else if (strcmp(argv[i], "--unix") == 0 && i + 1 < argc) {
+            unix_path = argv[++i];
+        } else if (strcmp(argv[i], "--sessions") == 0 && i + 1 < argc) {
+            num_sessions = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--seconds") == 0 && i + 1 < argc) {
+            seconds = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--server-dice") == 0) {
+            server_dice = 1;
+        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            seed = strtoull(argv[++i], NULL, 0);
+        } else {
+            printf("Usage: %s [--tcp host:port | --unix path] [--sessions N] [--seconds S] "
+                   "[--server-dice] [--seed S]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (num_sessions < 1 || seconds < 1) {
+        printf("Sessions and seconds must be positive!\n");
+        return 1;
+    }
+
+    // Resolve the server address
+    struct sockaddr_storage address;
+    socklen_t address_length;
+    memset(&address, 0, sizeof(address));
+    if (unix_path) {
+        struct sockaddr_un* un = (struct sockaddr_un*)&address;
+        un->sun_family = AF_UNIX;
+        snprintf(un->sun_path, sizeof(un->sun_path), "%s", unix_path);
+        address_length = sizeof(*un);
+    } else {
+        struct sockaddr_in* in = (struct sockaddr_in*)&address;
+        char host[64];
+        int port;
+        if (sscanf(tcp_arg, "%63[^:]:%d", host, &port) != 2 || inet_pton(AF_INET, host, &in->sin_addr) != 1) {
+            printf("Expected --tcp host:port with a numeric IPv4 host!\n");
+            return 1;
+        }
+        in->sin_family = AF_INET;
+        in->sin_port = htons((uint16_t)port);
+        address_length = sizeof(*in);
+    }
+
+    struct rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0) {
+        limit.rlim_cur = limit.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &limit);
+    }
+
+    Client* clients = calloc(num_sessions, sizeof(Client));
+    epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (clients == NULL || epoll_fd < 0) {
+        printf("Could not set up %d sessions!\n", num_sessions);
+        return 1;
+    }
+
+    for (int i = 0; i < num_sessions; i++) {
+        dice_seed(&clients[i].dice, game_seed(seed, i));
+        if (!connect_client(&clients[i], (struct sockaddr*)&address, address_length)) {
+            if (clients[i].fd >= 0) close(clients[i].fd);
+            clients[i].fd = -1;
+            failed_sessions++;
+        }
+    }
+
+    long start = now_ns();
+    long deadline = start + seconds * 1000000000L;
+    struct epoll_event events[LOADGEN_MAX_EVENTS];
+
+    while (now_ns() < deadline) {
+        int timeout = (int)((deadline - now_ns()) / 1000000) + 1;
+        int count = epoll_wait(epoll_fd, events, LOADGEN_MAX_EVENTS, timeout);
+        if (count < 0 && errno != EINTR) {
+            perror("epoll_wait");
+            break;
+        }
+        for (int i = 0; i < count; i++) {
+            Client* client = events[i].data.ptr;
+            if (client->fd >= 0 && !handle_input(client)) drop_client(client);
+        }
+    }
+    double elapsed = (now_ns() - start) / 1e9;
+
+    printf("Sessions:        %d (%ld failed)\n", num_sessions, failed_sessions);
+    printf("Games finished:  %ld (%.0f/s)\n", games_finished, games_finished / elapsed);
+    printf("Turns played:    %ld (%.0f/s)\n", turns_played, turns_played / elapsed);
+    if (round_trips > 0) {
+        printf("Round trip:      mean %.1f us, max %.1f us\n",
+               latency_total / 1e3 / round_trips, latency_max / 1e3);
+    }
+
+    for (int i = 0; i < num_sessions; i++) {
+        if (clients[i].fd >= 0) close(clients[i].fd);
+    }
+    free(clients);
+    close(epoll_fd);
+    return 0;
+}
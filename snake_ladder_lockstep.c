@@ -0,0 +1,306 @@
+/*SNAKE & LADDER GAME - SIMD LOCKSTEP SIMULATION KERNEL*/
+// Plays many two-player games side by side, one game per vector lane: every
+// step rolls for each lane's current player, gathers the destination from the
+// board's 32-bit jump table and masks off lanes whose game has ended.
+// Finished lanes are refilled with the next game of the range.
+//
+// Dice come from a counter-based hash of (seed, game index, roll index), so a
+// game's outcome does not depend on which lane or kernel played it: the
+// AVX-512, AVX2 and scalar kernels give identical results. The kernel is
+// picked at runtime from the CPU's features.
+#include <string.h>
+#include <pthread.h>
+#include "snake_ladder_lockstep.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define LOCKSTEP_X86 1
+#endif
+
+#define ROLL_GAMMA 0x9E3779B9u
+#define MAX_LANES 16
+
+typedef void (*LockstepKernel)(const int32_t* jump, int squares, uint64_t seed, long first,
+                               long count, SimStats* stats);
+
+// 32-bit integer hash (lowbias32)
+static inline uint32_t mix32(uint32_t x) {
+    x ^= x >> 16;
+    x *= 0x7FEB352Du;
+    x ^= x >> 15;
+    x *= 0x846CA68Bu;
+    x ^= x >> 16;
+    return x;
+}
+
+// Per-game key: every roll of the game is hashed from it. It is the full
+// 64-bit game seed, so no two games of a run share their dice.
+static inline uint64_t game_key(uint64_t seed, uint64_t game) {
+    return game_seed(seed, (long)game);
+}
+
+// Roll number `roll` (0-based) of the game with the given key: the low half
+// of the key is hashed with the roll number and the high half into the
+// result, so keys differing in either half give different rolls
+static inline int hashed_roll(uint64_t key, uint32_t roll) {
+    uint32_t x = mix32(mix32((uint32_t)key + roll * ROLL_GAMMA) ^ (uint32_t)(key >> 32));
+    return 1 + (int)(((x >> 8) * DICE_SIDES) >> 24);
+}
+
+// Count one finished game
+static inline void record_game(SimStats* stats, int winner, int turns) {
+    stats->games++;
+    stats->wins[winner]++;
+    stats->total_turns += turns;
+    stats->length_hist[turns < MAX_TRACKED_TURNS ? turns : MAX_TRACKED_TURNS]++;
+}
+
+// Scalar fallback: the same games, one at a time, for any number of players
+static void simulate_scalar_players(const int32_t* jump, int squares, int num_players,
+                                    uint64_t seed, long first, long count, SimStats* stats) {
+    int32_t position[MAX_PLAYERS];
+
+    for (long game = first; game < first + count; game++) {
+        uint64_t key = game_key(seed, (uint64_t)game);
+        int player = 0;
+        int turns = 0;
+
+        memset(position, 0, sizeof(position[0]) * num_players);
+        while (1) {
+            int square = jump[position[player] + hashed_roll(key, (uint32_t)turns)];
+            position[player] = square;
+            turns++;
+            if (square >= squares) {
+                record_game(stats, player, turns);
+                break;
+            }
+            if (++player == num_players) player = 0;
+        }
+    }
+}
+
+// Two-player scalar kernel
+static void simulate_scalar(const int32_t* jump, int squares, uint64_t seed, long first,
+                            long count, SimStats* stats) {
+    simulate_scalar_players(jump, squares, 2, seed, first, count, stats);
+}
+
+#ifdef LOCKSTEP_X86
+
+// Lane state spilled to memory while finished lanes are recorded and refilled
+typedef struct {
+    int32_t pos_a[MAX_LANES];
+    int32_t pos_b[MAX_LANES];
+    int32_t turns[MAX_LANES];
+    int32_t key_low[MAX_LANES];
+    int32_t key_high[MAX_LANES];
+    int32_t active[MAX_LANES];
+} LaneState;
+
+// Put the next game of the range in a lane, or retire the lane
+static void refill_lane(LaneState* lanes, int lane, uint64_t seed, long* next, long end) {
+    lanes->pos_a[lane] = 0;
+    lanes->pos_b[lane] = 0;
+    lanes->turns[lane] = 0;
+    lanes->active[lane] = *next < end ? -1 : 0;
+    uint64_t key = *next < end ? game_key(seed, (uint64_t)*next) : 0;
+    lanes->key_low[lane] = (int32_t)(uint32_t)key;
+    lanes->key_high[lane] = (int32_t)(uint32_t)(key >> 32);
+    if (*next < end) (*next)++;
+}
+
+// Record finished lanes and refill them; returns the number still active
+static int retire_lanes(LaneState* lanes, int lanes_used, unsigned finished, uint64_t seed,
+                        long* next, long end, SimStats* stats) {
+    int active = 0;
+    for (int lane = 0; lane < lanes_used; lane++) {
+        if (finished & (1u << lane)) {
+            // The move that finished the game was turns - 1; A moves on even turns
+            int turns = lanes->turns[lane];
+            record_game(stats, (turns - 1) & 1, turns);
+            refill_lane(lanes, lane, seed, next, end);
+        }
+        if (lanes->active[lane]) active++;
+    }
+    return active;
+}
+
+// mix32() of 8 lanes
+__attribute__((target("avx2")))
+static inline __m256i mix32_avx2(__m256i x) {
+    x = _mm256_xor_si256(x, _mm256_srli_epi32(x, 16));
+    x = _mm256_mullo_epi32(x, _mm256_set1_epi32(0x7FEB352D));
+    x = _mm256_xor_si256(x, _mm256_srli_epi32(x, 15));
+    x = _mm256_mullo_epi32(x, _mm256_set1_epi32((int)0x846CA68Bu));
+    return _mm256_xor_si256(x, _mm256_srli_epi32(x, 16));
+}
+
+// AVX2: 8 games per step
+__attribute__((target("avx2")))
+static void simulate_avx2(const int32_t* jump, int squares, uint64_t seed, long first,
+                          long count, SimStats* stats) {
+    LaneState lanes;
+    long next = first, end = first + count;
+    int active = 0;
+
+    for (int lane = 0; lane < 8; lane++) {
+        refill_lane(&lanes, lane, seed, &next, end);
+        if (lanes.active[lane]) active++;
+    }
+
+    const __m256i one = _mm256_set1_epi32(1);
+    const __m256i last_square = _mm256_set1_epi32(squares - 1);
+    const __m256i gamma = _mm256_set1_epi32((int)ROLL_GAMMA);
+    const __m256i sides = _mm256_set1_epi32(DICE_SIDES);
+
+    while (active > 0) {
+        __m256i pos_a = _mm256_loadu_si256((const __m256i*)lanes.pos_a);
+        __m256i pos_b = _mm256_loadu_si256((const __m256i*)lanes.pos_b);
+        __m256i turns = _mm256_loadu_si256((const __m256i*)lanes.turns);
+        __m256i key_low = _mm256_loadu_si256((const __m256i*)lanes.key_low);
+        __m256i key_high = _mm256_loadu_si256((const __m256i*)lanes.key_high);
+        __m256i live = _mm256_loadu_si256((const __m256i*)lanes.active);
+        unsigned finished;
+
+        do {
+            // Player B moves on odd turns
+            __m256i b_moves = _mm256_cmpeq_epi32(_mm256_and_si256(turns, one), one);
+            __m256i current = _mm256_blendv_epi8(pos_a, pos_b, b_moves);
+
+            // Hashed dice roll for every lane
+            __m256i x = mix32_avx2(_mm256_add_epi32(key_low, _mm256_mullo_epi32(turns, gamma)));
+            x = mix32_avx2(_mm256_xor_si256(x, key_high));
+            __m256i roll = _mm256_srli_epi32(_mm256_mullo_epi32(_mm256_srli_epi32(x, 8), sides), 24);
+            roll = _mm256_add_epi32(roll, one);
+
+            // One gather resolves every lane's snake or ladder
+            __m256i square = _mm256_i32gather_epi32((const int*)jump, _mm256_add_epi32(current, roll), 4);
+            square = _mm256_and_si256(square, live);
+
+            pos_a = _mm256_blendv_epi8(square, pos_a, b_moves);
+            pos_b = _mm256_blendv_epi8(pos_b, square, b_moves);
+            turns = _mm256_add_epi32(turns, one);
+
+            __m256i done = _mm256_and_si256(_mm256_cmpgt_epi32(square, last_square), live);
+            finished = (unsigned)_mm256_movemask_ps(_mm256_castsi256_ps(done));
+        } while (!finished);
+
+        _mm256_storeu_si256((__m256i*)lanes.pos_a, pos_a);
+        _mm256_storeu_si256((__m256i*)lanes.pos_b, pos_b);
+        _mm256_storeu_si256((__m256i*)lanes.turns, turns);
+        active = retire_lanes(&lanes, 8, finished, seed, &next, end, stats);
+    }
+}
+
+// mix32() of 16 lanes
+__attribute__((target("avx512f")))
+static inline __m512i mix32_avx512(__m512i x) {
+    x = _mm512_xor_si512(x, _mm512_srli_epi32(x, 16));
+    x = _mm512_mullo_epi32(x, _mm512_set1_epi32(0x7FEB352D));
+    x = _mm512_xor_si512(x, _mm512_srli_epi32(x, 15));
+    x = _mm512_mullo_epi32(x, _mm512_set1_epi32((int)0x846CA68Bu));
+    return _mm512_xor_si512(x, _mm512_srli_epi32(x, 16));
+}
+
+// AVX-512: 16 games per step, with mask registers for lane selection
+__attribute__((target("avx512f")))
+static void simulate_avx512(const int32_t* jump, int squares, uint64_t seed, long first,
+                            long count, SimStats* stats) {
+    LaneState lanes;
+    long next = first, end = first + count;
+    int active = 0;
+
+    for (int lane = 0; lane < 16; lane++) {
+        refill_lane(&lanes, lane, seed, &next, end);
+        if (lanes.active[lane]) active++;
+    }
+
+    const __m512i one = _mm512_set1_epi32(1);
+    const __m512i last_square = _mm512_set1_epi32(squares - 1);
+    const __m512i gamma = _mm512_set1_epi32((int)ROLL_GAMMA);
+    const __m512i sides = _mm512_set1_epi32(DICE_SIDES);
+
+    while (active > 0) {
+        __m512i pos_a = _mm512_loadu_si512(lanes.pos_a);
+        __m512i pos_b = _mm512_loadu_si512(lanes.pos_b);
+        __m512i turns = _mm512_loadu_si512(lanes.turns);
+        __m512i key_low = _mm512_loadu_si512(lanes.key_low);
+        __m512i key_high = _mm512_loadu_si512(lanes.key_high);
+        __mmask16 live = _mm512_cmpneq_epi32_mask(_mm512_loadu_si512(lanes.active), _mm512_setzero_si512());
+        __mmask16 finished;
+
+        do {
+            __mmask16 b_moves = _mm512_test_epi32_mask(turns, one);
+            __m512i current = _mm512_mask_blend_epi32(b_moves, pos_a, pos_b);
+
+            __m512i x = mix32_avx512(_mm512_add_epi32(key_low, _mm512_mullo_epi32(turns, gamma)));
+            x = mix32_avx512(_mm512_xor_si512(x, key_high));
+            __m512i roll = _mm512_srli_epi32(_mm512_mullo_epi32(_mm512_srli_epi32(x, 8), sides), 24);
+            roll = _mm512_add_epi32(roll, one);
+
+            __m512i square = _mm512_mask_i32gather_epi32(_mm512_setzero_si512(), live,
+                                                          _mm512_add_epi32(current, roll), jump, 4);
+
+            pos_a = _mm512_mask_mov_epi32(pos_a, ~b_moves, square);
+            pos_b = _mm512_mask_mov_epi32(pos_b, b_moves, square);
+            turns = _mm512_add_epi32(turns, one);
+
+            finished = _mm512_mask_cmpgt_epi32_mask(live, square, last_square);
+        } while (!finished);
+
+        _mm512_storeu_si512(lanes.pos_a, pos_a);
+        _mm512_storeu_si512(lanes.pos_b, pos_b);
+        _mm512_storeu_si512(lanes.turns, turns);
+        active = retire_lanes(&lanes, 16, finished, seed, &next, end, stats);
+    }
+}
+
+#endif
+
+// Pick the widest kernel this CPU supports
+static LockstepKernel select_kernel(const char** name) {
+#ifdef LOCKSTEP_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+        *name = "avx512";
+        return simulate_avx512;
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        *name = "avx2";
+        return simulate_avx2;
+    }
+#endif
+    *name = "scalar";
+    return simulate_scalar;
+}
+
+// Chosen once, before any worker reads it
+static LockstepKernel kernel = NULL;
+static const char* kernel_name = NULL;
+static pthread_once_t kernel_once = PTHREAD_ONCE_INIT;
+
+static void choose_kernel() {
+    kernel = select_kernel(&kernel_name);
+}
+
+// Name of the kernel chosen for this CPU
+const char* lockstep_kernel_name() {
+    pthread_once(&kernel_once, choose_kernel);
+    return kernel_name;
+}
+
+// Simulate games first .. first + count - 1 with the lockstep kernel
+void lockstep_simulate_range(const SimConfig* config, long first, long count, SimStats* stats) {
+    // The jump table is 32-bit and padded past the last square, so every
+    // position + roll can be gathered from it directly
+    const int32_t* jump = config->board->dest;
+    int squares = config->board->squares;
+
+    pthread_once(&kernel_once, choose_kernel);
+
+    if (config->num_players == 2) {
+        kernel(jump, squares, config->seed, first, count, stats);
+    } else {
+        simulate_scalar_players(jump, squares, config->num_players, config->seed, first, count, stats);
+    }
+}
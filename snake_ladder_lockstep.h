@@ -0,0 +1,10 @@
+/*SNAKE & LADDER GAME - SIMD LOCKSTEP SIMULATION KERNEL*/
+#ifndef SNAKE_LADDER_LOCKSTEP_H
+#define SNAKE_LADDER_LOCKSTEP_H
+
+#include "snake_ladder_core.h"
+
+const char* lockstep_kernel_name();
+void lockstep_simulate_range(const SimConfig* config, long first, long count, SimStats* stats);
+
+#endif
@@ -0,0 +1,226 @@
+/*SNAKE & LADDER GAME - EXACT MARKOV-CHAIN ANALYZER*/
+// Each player's walk is an absorbing Markov chain over the squares plus a
+// "finished" state. Without snakes and ladders one turn would just spread
+// each square's mass over the six squares above it, so a turn is computed as
+// a sliding sum of the six squares below every square, a branch-free loop the
+// compiler vectorizes; the mass landing on a snake or ladder is then moved to
+// its far end. Players never interact, so the game-level numbers follow from
+// the single-player finish distribution.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "snake_ladder_markov.h"
+
+// Transitions over the unfinished squares: the dice window plus the jumps
+typedef struct {
+    int states;
+    int jumps;
+    int* jump_from;
+    int* jump_to;           // states for a ladder that finishes the game
+    double* jump_mass;      // [jump] scratch for one turn
+    int finishers;          // squares a roll can finish the game from
+    int* finish_square;
+    double* finish_weight;  // probability of finishing from each of them
+} Transitions;
+
+// Release a transition matrix
+static void free_transitions(Transitions* tr) {
+    free(tr->jump_from);
+    free(tr->jump_to);
+    free(tr->jump_mass);
+    free(tr->finish_square);
+    free(tr->finish_weight);
+}
+
+// Build the transitions for fair dice on the given board
+static int build_transitions(const Board* board, Transitions* tr) {
+    int states = board->squares;
+
+    tr->states = states;
+    tr->jumps = 0;
+    tr->finishers = 0;
+    tr->jump_from = malloc(sizeof(int) * states);
+    tr->jump_to = malloc(sizeof(int) * states);
+    tr->jump_mass = malloc(sizeof(double) * states);
+    tr->finish_square = malloc(sizeof(int) * states);
+    tr->finish_weight = malloc(sizeof(double) * states);
+    if (!tr->jump_from || !tr->jump_to || !tr->jump_mass || !tr->finish_square || !tr->finish_weight) {
+        free_transitions(tr);
+        return 0;
+    }
+
+    for (int square = 0; square < states; square++) {
+        int to = board_jump(board, square);
+        if (to != square) {
+            tr->jump_from[tr->jumps] = square;
+            tr->jump_to[tr->jumps] = to < states ? to : states;
+            tr->jumps++;
+        }
+
+        int finishing = 0;
+        for (int roll = 1; roll <= DICE_SIDES; roll++) {
+            if (board_jump(board, square + roll) >= states) finishing++;
+        }
+        if (finishing > 0) {
+            tr->finish_square[tr->finishers] = square;
+            tr->finish_weight[tr->finishers] = (double)finishing / DICE_SIDES;
+            tr->finishers++;
+        }
+    }
+    return 1;
+}
+
+// One turn: next = A * current. Both vectors have DICE_SIDES zeros before
+// square 0 and a spare slot after the last square for finishing ladders.
+static void transition_step(const Transitions* tr, const double* restrict current,
+                            double* restrict next) {
+    for (int square = 0; square < tr->states; square++) {
+        double sum = current[square - 6] + current[square - 5] + current[square - 4] +
+                     current[square - 3] + current[square - 2] + current[square - 1];
+        next[square] = sum * (1.0 / DICE_SIDES);
+    }
+
+    // Take the mass off every jump first, so that a jump ending where
+    // another starts does not carry the mass on a second time
+    for (int k = 0; k < tr->jumps; k++) {
+        tr->jump_mass[k] = next[tr->jump_from[k]];
+        next[tr->jump_from[k]] = 0.0;
+    }
+    for (int k = 0; k < tr->jumps; k++) next[tr->jump_to[k]] += tr->jump_mass[k];
+}
+
+// Probability of finishing on the turn played from a state vector
+static double finish_mass(const Transitions* tr, const double* x) {
+    double sum = 0.0;
+    for (int k = 0; k < tr->finishers; k++) sum += tr->finish_weight[k] * x[tr->finish_square[k]];
+    return sum;
+}
+
+// Total probability mass of a state vector
+static double mass(const double* x, int n) {
+    double sum[4] = {0.0, 0.0, 0.0, 0.0};
+    int i;
+    for (i = 0; i + 4 <= n; i += 4) {
+        for (int j = 0; j < 4; j++) sum[j] += x[i + j];
+    }
+    for (; i < n; i++) sum[0] += x[i];
+    return (sum[0] + sum[1]) + (sum[2] + sum[3]);
+}
+
+// Whether next is current scaled by ratio, to within MARKOV_SETTLED_TOLERANCE
+// of next's total mass
+static int settled(const double* restrict current, const double* restrict next, int n, double ratio,
+                   double total) {
+    double sum[4] = {0.0, 0.0, 0.0, 0.0};
+    int i;
+    for (i = 0; i + 4 <= n; i += 4) {
+        for (int j = 0; j < 4; j++) sum[j] += fabs(next[i + j] - ratio * current[i + j]);
+    }
+    for (; i < n; i++) sum[0] += fabs(next[i] - ratio * current[i]);
+    return (sum[0] + sum[1]) + (sum[2] + sum[3]) <= MARKOV_SETTLED_TOLERANCE * total;
+}
+
+// Compute the exact game-length distribution and win probabilities
+int markov_analyze(const Board* board, int num_players, int max_turns, MarkovResult* result) {
+    Transitions tr;
+    int states = board->squares;
+
+    memset(result, 0, sizeof(*result));
+    result->num_players = num_players;
+    result->max_turns = max_turns;
+    result->player_finish = calloc(max_turns + 1, sizeof(double));
+    result->game_length = calloc((size_t)(max_turns + 1) * num_players, sizeof(double));
+    double* survive = calloc(max_turns + 1, sizeof(double));
+    double* buffer[2] = {calloc(DICE_SIDES + states + 1, sizeof(double)),
+                         calloc(DICE_SIDES + states + 1, sizeof(double))};
+    if (!result->player_finish || !result->game_length || !survive || !buffer[0] || !buffer[1] ||
+        !build_transitions(board, &tr)) {
+        printf("Out of memory in Markov analyzer!\n");
+        free(survive);
+        free(buffer[0]);
+        free(buffer[1]);
+        markov_free(result);
+        return 0;
+    }
+
+    // Single-player finish distribution: f(t) and survival S(t) = P(T > t)
+    double* state[2] = {buffer[0] + DICE_SIDES, buffer[1] + DICE_SIDES};
+    state[0][0] = 1.0;
+    survive[0] = 1.0;
+
+    // Once every square's mass shrinks by the same factor each turn, the
+    // same share of the survivors finishes every turn, so the rest of the
+    // distribution is geometric and needs no more steps
+    int geometric = 0;
+    double finish_rate = 0.0;
+    int t;
+    for (t = 1; t <= max_turns; t++) {
+        if (geometric) {
+            result->player_finish[t] = survive[t - 1] * finish_rate;
+            survive[t] = survive[t - 1] * (1.0 - finish_rate);
+        } else {
+            const double* current = state[(t - 1) & 1];
+            double* next = state[t & 1];
+
+            result->player_finish[t] = finish_mass(&tr, current);
+            transition_step(&tr, current, next);
+            survive[t] = mass(next, states);
+            if (t % MARKOV_SETTLED_CHECK == 0 && survive[t] > 0.0 &&
+                settled(current, next, states, survive[t] / survive[t - 1], survive[t])) {
+                geometric = 1;
+                finish_rate = result->player_finish[t] / survive[t - 1];
+            }
+        }
+        if (survive[t] < MARKOV_EPSILON) break;
+    }
+    result->turns_tracked = t <= max_turns ? t : max_turns;
+    result->tail_mass = survive[result->turns_tracked];
+
+    double m1 = 0.0, m2 = 0.0;
+    for (t = 1; t <= result->turns_tracked; t++) {
+        m1 += t * result->player_finish[t];
+        m2 += (double)t * t * result->player_finish[t];
+    }
+    result->player_expected_turns = m1;
+    result->player_turns_variance = m2 - m1 * m1;
+
+    // Player p wins on round t when it finishes then, players before it have
+    // not finished by round t and players after it not by round t - 1
+    double g1 = 0.0, g2 = 0.0;
+    for (t = 1; t <= result->turns_tracked; t++) {
+        // [p] = S(t)^p and S(t - 1)^p
+        double finished_power[MAX_PLAYERS], waiting_power[MAX_PLAYERS];
+        finished_power[0] = waiting_power[0] = 1.0;
+        for (int p = 1; p < num_players; p++) {
+            finished_power[p] = finished_power[p - 1] * survive[t];
+            waiting_power[p] = waiting_power[p - 1] * survive[t - 1];
+        }
+
+        for (int p = 0; p < num_players; p++) {
+            double prob = result->player_finish[t] * finished_power[p] * waiting_power[num_players - 1 - p];
+            int length = (t - 1) * num_players + p + 1;
+
+            result->game_length[length] = prob;
+            result->win_probability[p] += prob;
+            g1 += length * prob;
+            g2 += (double)length * length * prob;
+        }
+    }
+    result->game_expected_turns = g1;
+    result->game_turns_variance = g2 - g1 * g1;
+
+    free_transitions(&tr);
+    free(survive);
+    free(buffer[0]);
+    free(buffer[1]);
+    return 1;
+}
+
+// Release the distributions held by a result
+void markov_free(MarkovResult* result) {
+    free(result->player_finish);
+    free(result->game_length);
+    result->player_finish = NULL;
+    result->game_length = NULL;
+}
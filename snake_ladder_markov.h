@@ -0,0 +1,38 @@
+/*SNAKE & LADDER GAME - EXACT MARKOV-CHAIN ANALYZER*/
+#ifndef SNAKE_LADDER_MARKOV_H
+#define SNAKE_LADDER_MARKOV_H
+
+#include "snake_ladder_core.h"
+
+// Default cap on the number of turns per player that are tracked; larger
+// boards get proportionally more
+#define MARKOV_DEFAULT_MAX_TURNS 4096
+#define MARKOV_TURNS_PER_SQUARE 8
+
+// Probability below which the remaining (unfinished) mass is ignored
+#define MARKOV_EPSILON 1e-15
+
+// Relative change below which a turn is taken to scale every square's mass
+// by the same factor; later turns then decay geometrically
+#define MARKOV_SETTLED_TOLERANCE 1e-13
+#define MARKOV_SETTLED_CHECK 8      // turns between checks
+
+// Exact game-length statistics for a board with fair dice
+typedef struct {
+    int num_players;
+    int max_turns;              // length of player_finish
+    int turns_tracked;          // turns actually computed before the tail vanished
+    double* player_finish;      // [t] = P(a player finishes on its own turn t)
+    double* game_length;        // [t] = P(the game ends on overall turn t), t <= max_turns * num_players
+    double player_expected_turns;
+    double player_turns_variance;
+    double game_expected_turns;
+    double game_turns_variance;
+    double win_probability[MAX_PLAYERS];
+    double tail_mass;           // probability still unfinished after turns_tracked
+} MarkovResult;
+
+int markov_analyze(const Board* board, int num_players, int max_turns, MarkovResult* result);
+void markov_free(MarkovResult* result);
+
+#endif
@@ -1,4 +1,14 @@
 /*SNAKE & LADDER GAME - MODERNIZED VERSION*/
+// Build: cc -O2 -o snake_ladder_modern snake_ladder_modern.c snake_ladder_core.c snake_ladder_policy.c snake_ladder_ai.c -lSDL2 -lSDL2_ttf -lm
+// Usage: ./snake_ladder_modern [--players N] [--headless] [--frames DIR] [--stats FILE] [--hints] [--ai] [board file]
+//
+// --headless draws into an offscreen surface with no window or audio and runs
+// delays on a virtual clock; input comes from stdin and the game ends with it.
+// --frames DIR writes every presented frame to DIR/frame_NNNNNN.ppm.
+// --stats FILE appends render statistics to FILE as a JSON line every few
+// seconds; F3 shows them over the game.
+// --hints shows the best number to enter in a two-player game.
+// --ai makes player B the computer in a two-player game.
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -6,6 +16,9 @@
 #include <time.h>
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_ttf.h>
+#include "snake_ladder_core.h"
+#include "snake_ladder_policy.h"
+#include "snake_ladder_ai.h"
 
 // Screen dimensions
 #define SCREEN_WIDTH 640
@@ -29,53 +42,287 @@
 #define COLOR_LIGHT_BLUE (SDL_Color){173, 216, 230, 255}
 #define COLOR_BROWN (SDL_Color){139, 69, 19, 255}
 
+// Printable ASCII range held in a glyph atlas
+#define FIRST_GLYPH 32
+#define LAST_GLYPH 126
+#define GLYPH_COUNT (LAST_GLYPH - FIRST_GLYPH + 1)
+#define ATLAS_MAX_WIDTH 1024
+
+// Scheduled callbacks run from the event loop
+#define MAX_SCHEDULED_CALLBACKS 16
+
+// Callback run by the event loop; returns the delay until it should run
+// again, or 0 to stop
+typedef Uint32 (*ScheduledFunction)(void* data);
+
+typedef struct {
+    int active;
+    Uint32 due;
+    ScheduledFunction function;
+    void* data;
+} ScheduledCallback;
+
+// Numbers typed on the keyboard, clicked, or read from the terminal
+#define INPUT_QUEUE_SIZE 32
+#define INPUT_WAIT_MS 60000
+
+// Menu option rows, for mouse clicks
+#define MENU_X 320
+#define MENU_Y 230
+#define MENU_ROW_HEIGHT 20
+#define MENU_OPTIONS 3
+
+// Players that fit in the legend below the board
+#define MAX_GUI_PLAYERS 6
+#define LEGEND_BOX_WIDTH 48
+
+// Board area on screen and token size
+#define BOARD_X 20
+#define BOARD_Y 0
+#define TOKEN_WIDTH 14
+#define TOKEN_HEIGHT 10
+
+// Tokens sharing a square are staggered in rows of three
+#define TOKEN_STEP_X 15
+#define TOKEN_STEP_Y 11
+#define TOKENS_PER_ROW 3
+
+// Regions a single game frame can damage: two cells per moved player, the
+// old and new flash cells and the status line
+#define MAX_DIRTY_RECTS (2 * MAX_GUI_PLAYERS + 3)
+#define STATUS_Y 430
+
+// How long a snake or ladder square stays highlighted
+#define JUMP_FLASH_MS 300
+
+// Computer player: thinking time per move, and how often the frame loop
+// checks whether it has finished. Headless runs search a fixed depth with
+// no clock instead, so they repeat on any machine.
+#define AI_BUDGET_MS 300
+#define AI_POLL_MS 15
+#define AI_HEADLESS_DEPTH 6
+
+// Frame dumps: frames waiting to be written and the threads writing them
+#define FRAME_SLOTS 8
+#define MAX_FRAME_WRITERS 4
+
+// Render statistics: log2 histogram buckets and the F3 overlay
+#define STATS_BUCKETS 24
+#define STATS_DUMP_MS 5000
+#define STATS_OVERLAY_WIDTH 300
+#define STATS_LINE_HEIGHT 20
+
+// Where every square of the board is drawn, computed once per board size.
+// Index 0 is unused; index `squares` is the finish square.
+typedef struct {
+    int rows;
+    int cols;
+    int squares;
+    int cell_width;
+    int cell_height;
+    SDL_Rect* cells;    // squares + 1 entries
+    SDL_Point* tokens;  // squares + 1 entries, top-left of the first token
+} BoardLayout;
+
+// A captured frame on its way to disk
+typedef enum {
+    SLOT_FREE,
+    SLOT_BUSY,          // being captured or written
+    SLOT_QUEUED         // captured, waiting for a writer
+} FrameSlotState;
+
+typedef struct {
+    FrameSlotState state;
+    int number;
+    Uint32* pixels;     // ARGB8888, SCREEN_WIDTH x SCREEN_HEIGHT
+} FrameSlot;
+
+// Worker threads turning captured frames into PPM files
+typedef struct {
+    SDL_mutex* lock;
+    SDL_cond* changed;
+    SDL_Thread* threads[MAX_FRAME_WRITERS];
+    int thread_count;
+    int stopping;
+    int next_number;
+    long written;
+    long failed;
+    const char* dir;
+    FrameSlot slots[FRAME_SLOTS];
+} FrameWriter;
+
+// Distribution of one measurement; bucket b counts values in [2^b, 2^(b+1)),
+// bucket 0 everything below 2
+typedef struct {
+    long count;
+    double total;
+    double max;
+    long buckets[STATS_BUCKETS];
+} Histogram;
+
+// Counters for finding rendering regressions. Frame time is the time spent
+// producing a frame: from the end of one present to the end of the next,
+// less the time waited in the event loop in between.
+typedef struct {
+    Histogram frame_us;
+    Histogram present_us;
+    Histogram draw_calls;           // per frame
+    Histogram textures;             // textures created per frame
+    Histogram delay_us;             // wall time of each delay_ms() call
+    long frame_draw_calls;
+    long frame_textures;
+    Uint64 frame_start;             // performance counter
+    Uint64 frame_waited;            // performance counter ticks
+    double last_frame_us;
+    double last_present_us;
+    long last_draw_calls;
+    long last_textures;
+} RenderStats;
+
+// All glyphs of one font, rendered once into a single texture
+typedef struct {
+    SDL_Texture* texture;
+    SDL_Rect glyphs[GLYPH_COUNT];
+    int advance[GLYPH_COUNT];
+} GlyphAtlas;
+
+// A move being searched on a worker thread
+typedef struct {
+    VariantState state;
+    AiResult result;
+    SDL_atomic_t done;
+} AiJob;
+
 // Global variables
 SDL_Window* window = NULL;
 SDL_Renderer* renderer = NULL;
 TTF_Font* font = NULL;
 TTF_Font* small_font = NULL;
+GlyphAtlas text_atlas;
+GlyphAtlas small_text_atlas;
+SDL_Texture* board_texture = NULL;
+SDL_Texture* frame_texture = NULL;
+int frame_valid = 0;
+int32_t frame_positions[MAX_PLAYERS];
+int frame_flash = 0;
+ScheduledCallback scheduled[MAX_SCHEDULED_CALLBACKS];
+int quit_requested = 0;
+int input_queue[INPUT_QUEUE_SIZE];
+int input_head = 0;
+int input_count = 0;
+int prompt_waiting = 0;
+Uint32 stdin_event_type = (Uint32)-1;
+int menu_active = 0;
+int num_players = DEFAULT_PLAYERS;
+Board board;
+BoardLayout layout;
+int headless = 0;
+SDL_Surface* offscreen = NULL;
+Uint32 virtual_ticks = 0;
+const char* frame_dir = NULL;
+FrameWriter frame_writer;
+RenderStats render_stats;
+int show_stats_overlay = 0;
+const char* stats_path = NULL;
+int show_hints = 0;
+PolicyTable policy;
+int computer_player = -1;
+AiSearch ai_search;
 
 // Function prototypes
 int init_graphics();
 void cleanup_graphics();
+Uint32 game_ticks();
+int start_frame_writer(const char* dir);
+void stop_frame_writer();
+void capture_frame();
+void present_frame();
+void record_sample(Histogram* histogram, double value);
+double histogram_percentile(const Histogram* histogram, double fraction);
+void reset_render_stats();
+void draw_stats_overlay();
+int write_render_stats(const char* path);
+Uint32 dump_render_stats(void* data);
 void set_background_color(SDL_Color color);
 void clear_screen();
+int build_glyph_atlas(TTF_Font* source, GlyphAtlas* atlas);
+void free_glyph_atlas(GlyphAtlas* atlas);
+void draw_atlas_text(GlyphAtlas* atlas, int x, int y, const char* text, SDL_Color color);
 void draw_text(int x, int y, const char* text, SDL_Color color);
+void draw_small_text(int x, int y, const char* text, SDL_Color color);
+int atlas_text_width(const GlyphAtlas* atlas, const char* text);
 void draw_rectangle(int x, int y, int width, int height, SDL_Color color);
 void draw_filled_rectangle(int x, int y, int width, int height, SDL_Color color);
 void draw_line(int x1, int y1, int x2, int y2, SDL_Color color);
-void delay_ms(int milliseconds);
+int schedule_callback(Uint32 delay, ScheduledFunction function, void* data);
+void cancel_callback(int id);
+void handle_event(const SDL_Event* event);
+int run_event_loop(Uint32 deadline);
+int delay_ms(int milliseconds);
+void push_input(int value);
+void push_prompt_input(int value);
+int pop_input(int* value);
+int stdin_reader(void* data);
+void start_stdin_reader();
+int wait_for_input(int* value);
 void play_sound();
+int build_board_layout(BoardLayout* layout, const Board* board, int width, int height);
+void free_board_layout(BoardLayout* layout);
+void draw_board_static();
+int render_board_texture();
+int render_frame_texture();
 void draw_board();
+SDL_Color player_color(int player);
+SDL_Rect token_rect(int player, int square);
+SDL_Rect square_damage_rect(int square);
+void invalidate_game_frame();
+void draw_game_frame(const int32_t* positions, int flash_square, const char* status);
 void draw_player(int x, int y, SDL_Color color);
-void show_menu();
+void draw_menu(int frame);
+int show_menu();
 void show_instructions();
 void show_credits();
+void square_to_screen(int position, int* x, int* y);
+int computer_roll(const Game* game);
 void play_game();
 void handle_snake_ladder(int position, int* new_position, SDL_Color* effect_color);
 void show_winner(const char* player);
 
 // Initialize graphics system
 int init_graphics() {
-    if (SDL_Init(SDL_INIT_VIDEO | SDL_INIT_AUDIO) < 0) {
+    // Headless runs need no display: events only, no audio
+    if (headless) SDL_setenv("SDL_VIDEODRIVER", "dummy", 1);
+    if (SDL_Init(headless ? SDL_INIT_VIDEO : SDL_INIT_VIDEO | SDL_INIT_AUDIO) < 0) {
         printf("SDL could not initialize! SDL_Error: %s\n", SDL_GetError());
         return 0;
     }
+    reset_render_stats();
     
     if (TTF_Init() == -1) {
         printf("TTF could not initialize! TTF_Error: %s\n", TTF_GetError());
         return 0;
     }
     
-    window = SDL_CreateWindow("Snake & Ladder Game",
-                              SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED,
-                              SCREEN_WIDTH, SCREEN_HEIGHT, SDL_WINDOW_SHOWN);
-    if (window == NULL) {
-        printf("Window could not be created! SDL_Error: %s\n", SDL_GetError());
-        return 0;
+    if (headless) {
+        // Draw with the software renderer into a surface instead of a window
+        offscreen = SDL_CreateRGBSurfaceWithFormat(0, SCREEN_WIDTH, SCREEN_HEIGHT, 32,
+                                                   SDL_PIXELFORMAT_ARGB8888);
+        if (offscreen) renderer = SDL_CreateSoftwareRenderer(offscreen);
+    } else {
+        window = SDL_CreateWindow("Snake & Ladder Game",
+                                  SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED,
+                                  SCREEN_WIDTH, SCREEN_HEIGHT, SDL_WINDOW_SHOWN);
+        if (window == NULL) {
+            printf("Window could not be created! SDL_Error: %s\n", SDL_GetError());
+            return 0;
+        }
+        
+        renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED);
+        if (renderer == NULL) {
+            // No GPU (or SDL_RENDER_DRIVER=software): fall back to the software renderer
+            renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_SOFTWARE);
+        }
     }
-    
-    renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED);
     if (renderer == NULL) {
         printf("Renderer could not be created! SDL_Error: %s\n", SDL_GetError());
         return 0;
@@ -102,19 +349,330 @@ int init_graphics() {
         printf("Warning: Could not load fonts, text may not display properly\n");
     }
     
+    // Render every glyph once so drawing text is only texture copies
+    if (!build_glyph_atlas(font, &text_atlas) || !build_glyph_atlas(small_font, &small_text_atlas)) {
+        printf("Warning: Could not build glyph atlas, text may not display properly\n");
+    }
+    
+    if (frame_dir && !start_frame_writer(frame_dir)) {
+        return 0;
+    }
+    
     return 1;
 }
 
 // Cleanup graphics system
 void cleanup_graphics() {
+    stop_frame_writer();
+    if (board_texture) SDL_DestroyTexture(board_texture);
+    if (frame_texture) SDL_DestroyTexture(frame_texture);
+    free_glyph_atlas(&text_atlas);
+    free_glyph_atlas(&small_text_atlas);
     if (font) TTF_CloseFont(font);
     if (small_font) TTF_CloseFont(small_font);
     if (renderer) SDL_DestroyRenderer(renderer);
     if (window) SDL_DestroyWindow(window);
+    if (offscreen) SDL_FreeSurface(offscreen);
+    offscreen = NULL;
+    board_texture = frame_texture = NULL;
+    frame_valid = 0;
+    font = small_font = NULL;
+    renderer = NULL;
+    window = NULL;
     TTF_Quit();
     SDL_Quit();
 }
 
+// Milliseconds for delays and scheduled callbacks. Headless runs use a
+// virtual clock that jumps ahead instead of sleeping, so a run takes no
+// longer than its drawing and always produces the same frames.
+Uint32 game_ticks() {
+    return headless ? virtual_ticks : SDL_GetTicks();
+}
+
+// Find a frame slot in the given state (frame writer lock held)
+static FrameSlot* find_frame_slot(FrameSlotState state) {
+    FrameSlot* found = NULL;
+    for (int i = 0; i < FRAME_SLOTS; i++) {
+        FrameSlot* slot = &frame_writer.slots[i];
+        if (slot->state == state && (found == NULL || slot->number < found->number)) found = slot;
+    }
+    return found;
+}
+
+// Write one captured frame as a binary PPM file
+static int write_frame_file(const char* dir, int number, const Uint32* pixels) {
+    char path[1024];
+    Uint8 row[SCREEN_WIDTH * 3];
+    
+    snprintf(path, sizeof(path), "%s/frame_%06d.ppm", dir, number);
+    FILE* file = fopen(path, "wb");
+    if (file == NULL) return 0;
+    
+    int ok = fprintf(file, "P6\n%d %d\n255\n", SCREEN_WIDTH, SCREEN_HEIGHT) > 0;
+    for (int y = 0; ok && y < SCREEN_HEIGHT; y++) {
+        for (int x = 0; x < SCREEN_WIDTH; x++) {
+            Uint32 pixel = pixels[y * SCREEN_WIDTH + x];
+            row[x * 3] = (Uint8)(pixel >> 16);
+            row[x * 3 + 1] = (Uint8)(pixel >> 8);
+            row[x * 3 + 2] = (Uint8)pixel;
+        }
+        ok = fwrite(row, sizeof(row), 1, file) == 1;
+    }
+    if (fclose(file) != 0) ok = 0;
+    return ok;
+}
+
+// Frame writer thread: encode queued frames until asked to stop
+static int frame_writer_main(void* data) {
+    FrameWriter* writer = data;
+    
+    SDL_LockMutex(writer->lock);
+    while (1) {
+        FrameSlot* slot = find_frame_slot(SLOT_QUEUED);
+        if (slot == NULL) {
+            if (writer->stopping) break;
+            SDL_CondWait(writer->changed, writer->lock);
+            continue;
+        }
+        
+        slot->state = SLOT_BUSY;
+        SDL_UnlockMutex(writer->lock);
+        int ok = write_frame_file(writer->dir, slot->number, slot->pixels);
+        SDL_LockMutex(writer->lock);
+        
+        if (ok) writer->written++;
+        else writer->failed++;
+        slot->state = SLOT_FREE;
+        SDL_CondBroadcast(writer->changed);
+    }
+    SDL_UnlockMutex(writer->lock);
+    return 0;
+}
+
+// Start the threads that write every presented frame into a directory
+int start_frame_writer(const char* dir) {
+    FrameWriter* writer = &frame_writer;
+    
+    memset(writer, 0, sizeof(*writer));
+    writer->dir = dir;
+    writer->lock = SDL_CreateMutex();
+    writer->changed = SDL_CreateCond();
+    int ok = writer->lock != NULL && writer->changed != NULL;
+    for (int i = 0; ok && i < FRAME_SLOTS; i++) {
+        writer->slots[i].pixels = malloc(sizeof(Uint32) * SCREEN_WIDTH * SCREEN_HEIGHT);
+        ok = writer->slots[i].pixels != NULL;
+    }
+    
+    // Leave one core for drawing
+    int threads = SDL_GetCPUCount() - 1;
+    if (threads < 1) threads = 1;
+    if (threads > MAX_FRAME_WRITERS) threads = MAX_FRAME_WRITERS;
+    for (int i = 0; ok && i < threads; i++) {
+        writer->threads[i] = SDL_CreateThread(frame_writer_main, "frame_writer", writer);
+        if (writer->threads[i]) writer->thread_count++;
+    }
+    
+    if (!ok || writer->thread_count == 0) {
+        printf("Could not start the frame writer!\n");
+        stop_frame_writer();
+        return 0;
+    }
+    return 1;
+}
+
+// Wait for every queued frame to be written and stop the writer threads
+void stop_frame_writer() {
+    FrameWriter* writer = &frame_writer;
+    if (writer->lock == NULL) return;
+    
+    SDL_LockMutex(writer->lock);
+    writer->stopping = 1;
+    SDL_CondBroadcast(writer->changed);
+    SDL_UnlockMutex(writer->lock);
+    for (int i = 0; i < writer->thread_count; i++) {
+        SDL_WaitThread(writer->threads[i], NULL);
+    }
+    
+    if (writer->written > 0 || writer->failed > 0) {
+        printf("Wrote %ld frames to %s", writer->written, writer->dir);
+        if (writer->failed > 0) printf(" (%ld failed)", writer->failed);
+        printf("\n");
+    }
+    
+    for (int i = 0; i < FRAME_SLOTS; i++) free(writer->slots[i].pixels);
+    if (writer->changed) SDL_DestroyCond(writer->changed);
+    SDL_DestroyMutex(writer->lock);
+    memset(writer, 0, sizeof(*writer));
+}
+
+// Read the finished frame back into a free slot and queue it for the
+// writers; blocks only when every slot is still waiting to be written
+void capture_frame() {
+    FrameWriter* writer = &frame_writer;
+    FrameSlot* slot;
+    
+    SDL_LockMutex(writer->lock);
+    while ((slot = find_frame_slot(SLOT_FREE)) == NULL) {
+        SDL_CondWait(writer->changed, writer->lock);
+    }
+    slot->state = SLOT_BUSY;
+    SDL_UnlockMutex(writer->lock);
+    
+    int ok = SDL_RenderReadPixels(renderer, NULL, SDL_PIXELFORMAT_ARGB8888, slot->pixels,
+                                  SCREEN_WIDTH * sizeof(Uint32)) == 0;
+    
+    SDL_LockMutex(writer->lock);
+    if (ok) {
+        slot->number = writer->next_number++;
+        slot->state = SLOT_QUEUED;
+        SDL_CondBroadcast(writer->changed);
+    } else {
+        writer->failed++;
+        slot->state = SLOT_FREE;
+    }
+    SDL_UnlockMutex(writer->lock);
+}
+
+// Microseconds in a span of performance-counter ticks
+static double counter_us(Uint64 ticks) {
+    return (double)ticks * 1e6 / SDL_GetPerformanceFrequency();
+}
+
+// Show the finished frame. When frames are being dumped it is captured
+// first, since the back buffer is undefined after a present.
+void present_frame() {
+    RenderStats* stats = &render_stats;
+    
+    // The overlay's own drawing is not counted against the frame
+    stats->last_draw_calls = stats->frame_draw_calls;
+    stats->last_textures = stats->frame_textures;
+    record_sample(&stats->draw_calls, stats->frame_draw_calls);
+    record_sample(&stats->textures, stats->frame_textures);
+    if (show_stats_overlay) draw_stats_overlay();
+    if (frame_writer.lock) capture_frame();
+    
+    Uint64 start = SDL_GetPerformanceCounter();
+    SDL_RenderPresent(renderer);
+    Uint64 end = SDL_GetPerformanceCounter();
+    
+    stats->last_present_us = counter_us(end - start);
+    stats->last_frame_us = counter_us(end - stats->frame_start - stats->frame_waited);
+    record_sample(&stats->present_us, stats->last_present_us);
+    record_sample(&stats->frame_us, stats->last_frame_us);
+    stats->frame_draw_calls = 0;
+    stats->frame_textures = 0;
+    stats->frame_start = end;
+    stats->frame_waited = 0;
+}
+
+// Add one value to a histogram
+void record_sample(Histogram* histogram, double value) {
+    int bucket = 0;
+    while (bucket < STATS_BUCKETS - 1 && value >= (double)(2L << bucket)) bucket++;
+    
+    histogram->count++;
+    histogram->total += value;
+    if (value > histogram->max) histogram->max = value;
+    histogram->buckets[bucket]++;
+}
+
+// Upper bound of the bucket holding the given fraction of the values
+double histogram_percentile(const Histogram* histogram, double fraction) {
+    long seen = 0;
+    for (int bucket = 0; bucket < STATS_BUCKETS; bucket++) {
+        seen += histogram->buckets[bucket];
+        if (seen > 0 && seen >= fraction * histogram->count) {
+            double limit = (double)(2L << bucket);
+            return limit < histogram->max ? limit : histogram->max;
+        }
+    }
+    return histogram->max;
+}
+
+// Start a new statistics interval
+void reset_render_stats() {
+    Uint64 frame_start = render_stats.frame_start;
+    Uint64 frame_waited = render_stats.frame_waited;
+    long frame_draw_calls = render_stats.frame_draw_calls;
+    long frame_textures = render_stats.frame_textures;
+    
+    memset(&render_stats, 0, sizeof(render_stats));
+    render_stats.frame_start = frame_start ? frame_start : SDL_GetPerformanceCounter();
+    render_stats.frame_waited = frame_waited;
+    render_stats.frame_draw_calls = frame_draw_calls;
+    render_stats.frame_textures = frame_textures;
+}
+
+// Draw the last frame's numbers and this interval's distribution over the
+// top right corner of the screen
+void draw_stats_overlay() {
+    const RenderStats* stats = &render_stats;
+    const Histogram* frames = &stats->frame_us;
+    int x = SCREEN_WIDTH - STATS_OVERLAY_WIDTH;
+    char line[64];
+    
+    draw_filled_rectangle(x, 0, STATS_OVERLAY_WIDTH, 4 * STATS_LINE_HEIGHT + 4, COLOR_BLACK);
+    
+    snprintf(line, sizeof(line), "frame %.2f ms  present %.2f ms", stats->last_frame_us / 1e3,
+             stats->last_present_us / 1e3);
+    draw_small_text(x + 4, 2, line, COLOR_WHITE);
+    snprintf(line, sizeof(line), "mean %.2f  p99 %.2f  max %.2f ms",
+             frames->count ? frames->total / frames->count / 1e3 : 0.0,
+             histogram_percentile(frames, 0.99) / 1e3, frames->max / 1e3);
+    draw_small_text(x + 4, 2 + STATS_LINE_HEIGHT, line, COLOR_WHITE);
+    snprintf(line, sizeof(line), "draws %ld  textures %ld", stats->last_draw_calls, stats->last_textures);
+    draw_small_text(x + 4, 2 + 2 * STATS_LINE_HEIGHT, line, COLOR_WHITE);
+    snprintf(line, sizeof(line), "delays %ld  %.0f ms", stats->delay_us.count, stats->delay_us.total / 1e3);
+    draw_small_text(x + 4, 2 + 3 * STATS_LINE_HEIGHT, line, COLOR_WHITE);
+}
+
+// Write one histogram as a JSON object
+static void write_histogram(FILE* file, const char* name, const Histogram* histogram) {
+    fprintf(file, "\"%s\": {\"count\": %ld, \"mean\": %.1f, \"p50\": %.0f, \"p99\": %.0f, "
+            "\"max\": %.1f, \"buckets\": [", name, histogram->count,
+            histogram->count ? histogram->total / histogram->count : 0.0,
+            histogram_percentile(histogram, 0.5), histogram_percentile(histogram, 0.99), histogram->max);
+    for (int bucket = 0; bucket < STATS_BUCKETS; bucket++) {
+        fprintf(file, "%s%ld", bucket ? ", " : "", histogram->buckets[bucket]);
+    }
+    fprintf(file, "]}");
+}
+
+// Append this interval's statistics to a file as one JSON line
+int write_render_stats(const char* path) {
+    const RenderStats* stats = &render_stats;
+    FILE* file = fopen(path, "a");
+    if (file == NULL) {
+        printf("Could not open %s!\n", path);
+        return 0;
+    }
+    
+    fprintf(file, "{\"ticks\": %u, \"time_unit\": \"us\", ", (unsigned)game_ticks());
+    write_histogram(file, "frame", &stats->frame_us);
+    fprintf(file, ", ");
+    write_histogram(file, "present", &stats->present_us);
+    fprintf(file, ", ");
+    write_histogram(file, "draw_calls", &stats->draw_calls);
+    fprintf(file, ", ");
+    write_histogram(file, "textures_created", &stats->textures);
+    fprintf(file, ", ");
+    write_histogram(file, "delay", &stats->delay_us);
+    fprintf(file, "}\n");
+    
+    int ok = fclose(file) == 0;
+    if (!ok) printf("Could not write %s!\n", path);
+    return ok;
+}
+
+// Scheduled callback: dump the interval's statistics and start a new one
+Uint32 dump_render_stats(void* data) {
+    const char* path = data;
+    write_render_stats(path);
+    reset_render_stats();
+    return STATS_DUMP_MS;
+}
+
 // Set background color
 void set_background_color(SDL_Color color) {
     SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b, 255);
@@ -123,46 +681,102 @@ void set_background_color(SDL_Color color) {
 // Clear screen
 void clear_screen() {
     SDL_RenderClear(renderer);
+    render_stats.frame_draw_calls++;
 }
 
-// Draw text
-void draw_text(int x, int y, const char* text, SDL_Color color) {
-    if (!font) return;
+// Render the printable ASCII glyphs of a font into one texture
+int build_glyph_atlas(TTF_Font* source, GlyphAtlas* atlas) {
+    SDL_Surface* glyph_surfaces[GLYPH_COUNT];
+    int x = 0, y = 0, row_height = 0;
     
-    SDL_Surface* text_surface = TTF_RenderText_Solid(font, text, color);
-    if (text_surface == NULL) return;
+    memset(atlas, 0, sizeof(*atlas));
+    if (!source) return 0;
     
-    SDL_Texture* text_texture = SDL_CreateTextureFromSurface(renderer, text_surface);
-    if (text_texture == NULL) {
-        SDL_FreeSurface(text_surface);
-        return;
+    // Render each glyph and lay them out in rows
+    for (int i = 0; i < GLYPH_COUNT; i++) {
+        int min_x, max_x, min_y, max_y;
+        Uint16 ch = (Uint16)(FIRST_GLYPH + i);
+        
+        glyph_surfaces[i] = TTF_RenderGlyph_Solid(source, ch, COLOR_WHITE);
+        if (TTF_GlyphMetrics(source, ch, &min_x, &max_x, &min_y, &max_y, &atlas->advance[i]) != 0) {
+            atlas->advance[i] = glyph_surfaces[i] ? glyph_surfaces[i]->w : 0;
+        }
+        if (glyph_surfaces[i] == NULL) continue;
+        
+        if (x + glyph_surfaces[i]->w > ATLAS_MAX_WIDTH) {
+            x = 0;
+            y += row_height;
+            row_height = 0;
+        }
+        atlas->glyphs[i] = (SDL_Rect){x, y, glyph_surfaces[i]->w, glyph_surfaces[i]->h};
+        x += glyph_surfaces[i]->w;
+        if (glyph_surfaces[i]->h > row_height) row_height = glyph_surfaces[i]->h;
     }
     
-    SDL_Rect text_rect = {x, y, text_surface->w, text_surface->h};
-    SDL_RenderCopy(renderer, text_texture, NULL, &text_rect);
+    // Copy them into a transparent sheet and upload it once
+    SDL_Surface* sheet = SDL_CreateRGBSurfaceWithFormat(0, ATLAS_MAX_WIDTH, y + row_height,
+                                                        32, SDL_PIXELFORMAT_ARGB8888);
+    if (sheet != NULL) {
+        SDL_FillRect(sheet, NULL, 0);
+        for (int i = 0; i < GLYPH_COUNT; i++) {
+            if (glyph_surfaces[i]) SDL_BlitSurface(glyph_surfaces[i], NULL, sheet, &atlas->glyphs[i]);
+        }
+        atlas->texture = SDL_CreateTextureFromSurface(renderer, sheet);
+        if (atlas->texture != NULL) render_stats.frame_textures++;
+        SDL_FreeSurface(sheet);
+    }
+    
+    for (int i = 0; i < GLYPH_COUNT; i++) {
+        if (glyph_surfaces[i]) SDL_FreeSurface(glyph_surfaces[i]);
+    }
+    
+    if (atlas->texture == NULL) return 0;
+    SDL_SetTextureBlendMode(atlas->texture, SDL_BLENDMODE_BLEND);
+    return 1;
+}
+
+// Release a glyph atlas
+void free_glyph_atlas(GlyphAtlas* atlas) {
+    if (atlas->texture) SDL_DestroyTexture(atlas->texture);
+    atlas->texture = NULL;
+}
+
+// Draw text as one texture copy per glyph, tinted to the requested color
+void draw_atlas_text(GlyphAtlas* atlas, int x, int y, const char* text, SDL_Color color) {
+    if (!atlas->texture) return;
     
-    SDL_DestroyTexture(text_texture);
-    SDL_FreeSurface(text_surface);
+    SDL_SetTextureColorMod(atlas->texture, color.r, color.g, color.b);
+    for (const char* p = text; *p; p++) {
+        int ch = (unsigned char)*p;
+        if (ch < FIRST_GLYPH || ch > LAST_GLYPH) ch = '?';
+        
+        const SDL_Rect* glyph = &atlas->glyphs[ch - FIRST_GLYPH];
+        SDL_Rect dest = {x, y, glyph->w, glyph->h};
+        SDL_RenderCopy(renderer, atlas->texture, glyph, &dest);
+        render_stats.frame_draw_calls++;
+        x += atlas->advance[ch - FIRST_GLYPH];
+    }
+}
+
+// Draw text
+void draw_text(int x, int y, const char* text, SDL_Color color) {
+    draw_atlas_text(&text_atlas, x, y, text, color);
 }
 
 // Draw small text
 void draw_small_text(int x, int y, const char* text, SDL_Color color) {
-    if (!small_font) return;
-    
-    SDL_Surface* text_surface = TTF_RenderText_Solid(small_font, text, color);
-    if (text_surface == NULL) return;
-    
-    SDL_Texture* text_texture = SDL_CreateTextureFromSurface(renderer, text_surface);
-    if (text_texture == NULL) {
-        SDL_FreeSurface(text_surface);
-        return;
+    draw_atlas_text(&small_text_atlas, x, y, text, color);
+}
+
+// Width in pixels of text drawn with an atlas
+int atlas_text_width(const GlyphAtlas* atlas, const char* text) {
+    int width = 0;
+    for (const char* p = text; *p; p++) {
+        int ch = (unsigned char)*p;
+        if (ch < FIRST_GLYPH || ch > LAST_GLYPH) ch = '?';
+        width += atlas->advance[ch - FIRST_GLYPH];
     }
-    
-    SDL_Rect text_rect = {x, y, text_surface->w, text_surface->h};
-    SDL_RenderCopy(renderer, text_texture, NULL, &text_rect);
-    
-    SDL_DestroyTexture(text_texture);
-    SDL_FreeSurface(text_surface);
+    return width;
 }
 
 // Draw rectangle outline
@@ -170,6 +784,7 @@ void draw_rectangle(int x, int y, int width, int height, SDL_Color color) {
     SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b, 255);
     SDL_Rect rect = {x, y, width, height};
     SDL_RenderDrawRect(renderer, &rect);
+    render_stats.frame_draw_calls++;
 }
 
 // Draw filled rectangle
@@ -177,26 +792,205 @@ void draw_filled_rectangle(int x, int y, int width, int height, SDL_Color color)
     SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b, 255);
     SDL_Rect rect = {x, y, width, height};
     SDL_RenderFillRect(renderer, &rect);
+    render_stats.frame_draw_calls++;
 }
 
 // Draw line
 void draw_line(int x1, int y1, int x2, int y2, SDL_Color color) {
     SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b, 255);
     SDL_RenderDrawLine(renderer, x1, y1, x2, y2);
+    render_stats.frame_draw_calls++;
 }
 
-// Delay function with event processing
-void delay_ms(int milliseconds) {
-    Uint32 start = SDL_GetTicks();
-    while (SDL_GetTicks() - start < milliseconds) {
-        SDL_Event event;
-        while (SDL_PollEvent(&event)) {
-            if (event.type == SDL_QUIT) {
-                exit(0);
+// Run a function from the event loop after a delay; returns its id or -1
+int schedule_callback(Uint32 delay, ScheduledFunction function, void* data) {
+    for (int id = 0; id < MAX_SCHEDULED_CALLBACKS; id++) {
+        if (!scheduled[id].active) {
+            scheduled[id] = (ScheduledCallback){1, game_ticks() + delay, function, data};
+            return id;
+        }
+    }
+    printf("Warning: too many scheduled callbacks\n");
+    return -1;
+}
+
+// Stop a scheduled callback
+void cancel_callback(int id) {
+    if (id >= 0 && id < MAX_SCHEDULED_CALLBACKS) scheduled[id].active = 0;
+}
+
+// React to one SDL event
+void handle_event(const SDL_Event* event) {
+    switch (event->type) {
+        case SDL_QUIT:
+            quit_requested = 1;
+            break;
+        case SDL_RENDER_TARGETS_RESET:
+            // Target contents were lost; rebuild on the next frame
+            if (board_texture) SDL_DestroyTexture(board_texture);
+            board_texture = NULL;
+            frame_valid = 0;
+            break;
+        case SDL_KEYDOWN:
+            // A held key answers once, not once per auto-repeat
+            if (event->key.repeat) break;
+            if (event->key.keysym.sym >= SDLK_0 && event->key.keysym.sym <= SDLK_9) {
+                push_prompt_input(event->key.keysym.sym - SDLK_0);
+            } else if (event->key.keysym.sym >= SDLK_KP_1 && event->key.keysym.sym <= SDLK_KP_9) {
+                push_prompt_input(event->key.keysym.sym - SDLK_KP_1 + 1);
+            } else if (event->key.keysym.sym == SDLK_F3) {
+                show_stats_overlay = !show_stats_overlay;
+            }
+            break;
+        case SDL_MOUSEBUTTONDOWN:
+            // Clicking a menu line picks that option
+            if (menu_active && event->button.button == SDL_BUTTON_LEFT && event->button.x >= MENU_X) {
+                int row = (event->button.y - MENU_Y) / MENU_ROW_HEIGHT;
+                if (event->button.y >= MENU_Y && row < MENU_OPTIONS) push_prompt_input(row + 1);
+            }
+            break;
+        default:
+            if (event->type == stdin_event_type) push_input(event->user.code);
+            break;
+    }
+}
+
+// Run due callbacks and return the time until the next one (or fallback)
+static Uint32 run_due_callbacks(Uint32 now, Uint32 fallback) {
+    Uint32 wait = fallback;
+    
+    for (int id = 0; id < MAX_SCHEDULED_CALLBACKS; id++) {
+        if (!scheduled[id].active) continue;
+        
+        if (SDL_TICKS_PASSED(now, scheduled[id].due)) {
+            Uint32 again = scheduled[id].function(scheduled[id].data);
+            if (again == 0 || !scheduled[id].active) {
+                scheduled[id].active = 0;
+                continue;
             }
+            scheduled[id].due = now + again;
+        }
+        if (scheduled[id].due - now < wait) wait = scheduled[id].due - now;
+    }
+    return wait;
+}
+
+// Sleep in SDL_WaitEventTimeout until the deadline (or until input arrives,
+// if asked), dispatching events and scheduled callbacks as they come
+static void wait_events(Uint32 deadline, int stop_on_input) {
+    Uint64 start = SDL_GetPerformanceCounter();
+    
+    while (!quit_requested && !(stop_on_input && input_count > 0)) {
+        Uint32 now = game_ticks();
+        if (SDL_TICKS_PASSED(now, deadline)) break;
+        
+        Uint32 wait = run_due_callbacks(now, deadline - now);
+        
+        SDL_Event event;
+        if (headless && stop_on_input) {
+            // Input still arrives in real time; the virtual clock stands
+            // still while waiting for it
+            if (SDL_WaitEvent(&event)) handle_event(&event);
+            continue;
         }
-        SDL_Delay(10);
+        if (headless) {
+            while (SDL_PollEvent(&event)) handle_event(&event);
+            virtual_ticks = now + wait;
+            continue;
+        }
+        if (SDL_WaitEventTimeout(&event, (int)wait)) {
+            do {
+                handle_event(&event);
+            } while (SDL_PollEvent(&event));
+        }
+    }
+    render_stats.frame_waited += SDL_GetPerformanceCounter() - start;
+}
+
+// Process events until the deadline; returns 0 once quit has been requested
+int run_event_loop(Uint32 deadline) {
+    wait_events(deadline, 0);
+    return !quit_requested;
+}
+
+// Delay function with event processing; returns 0 once quit has been requested
+int delay_ms(int milliseconds) {
+    Uint64 start = SDL_GetPerformanceCounter();
+    int running = run_event_loop(game_ticks() + milliseconds);
+    record_sample(&render_stats.delay_us, counter_us(SDL_GetPerformanceCounter() - start));
+    return running;
+}
+
+// Queue a number entered by the player
+void push_input(int value) {
+    if (input_count == INPUT_QUEUE_SIZE) return;
+    input_queue[(input_head + input_count) % INPUT_QUEUE_SIZE] = value;
+    input_count++;
+}
+
+// Queue a number from the keyboard or mouse. It only counts while a prompt
+// is waiting and has no answer yet, so keys pressed between prompts or
+// twice in a row never answer a later prompt. Lines typed ahead on stdin
+// go through push_input() and keep their order.
+void push_prompt_input(int value) {
+    if (prompt_waiting && input_count == 0) push_input(value);
+}
+
+// Take the oldest queued number, if any
+int pop_input(int* value) {
+    if (input_count == 0) return 0;
+    *value = input_queue[input_head];
+    input_head = (input_head + 1) % INPUT_QUEUE_SIZE;
+    input_count--;
+    return 1;
+}
+
+// Background thread: forward numbers typed on the terminal as SDL events
+int stdin_reader(void* data) {
+    char line[64];
+    (void)data;
+    
+    while (fgets(line, sizeof(line), stdin)) {
+        SDL_Event event;
+        memset(&event, 0, sizeof(event));
+        event.type = stdin_event_type;
+        event.user.code = atoi(line);
+        SDL_PushEvent(&event);
+    }
+    
+    // A headless run is scripted from stdin and ends with it
+    if (headless) {
+        SDL_Event event;
+        memset(&event, 0, sizeof(event));
+        event.type = SDL_QUIT;
+        SDL_PushEvent(&event);
     }
+    return 0;
+}
+
+// Start reading terminal input without blocking the window
+void start_stdin_reader() {
+    stdin_event_type = SDL_RegisterEvents(1);
+    if (stdin_event_type == (Uint32)-1) return;
+    
+    SDL_Thread* thread = SDL_CreateThread(stdin_reader, "stdin_reader", NULL);
+    if (thread) SDL_DetachThread(thread);
+}
+
+// Keep the window live until the player enters a number; returns 0 on quit
+int wait_for_input(int* value) {
+    // Clicks and keys still queued from before the prompt appeared do not
+    // answer it
+    SDL_PumpEvents();
+    SDL_FlushEvents(SDL_KEYDOWN, SDL_KEYUP);
+    SDL_FlushEvent(SDL_MOUSEBUTTONDOWN);
+
+    prompt_waiting = 1;
+    while (!pop_input(value) && !quit_requested) {
+        wait_events(game_ticks() + INPUT_WAIT_MS, 1);
+    }
+    prompt_waiting = 0;
+    return !quit_requested;
 }
 
 // Play sound (placeholder - would need SDL_mixer for actual sound)
@@ -205,10 +999,59 @@ void play_sound() {
     printf("Beep!\n");
 }
 
-// Draw the game board
-void draw_board() {
+// Lay the board's squares out on a width x height area: square 1 is bottom
+// right and rows alternate direction, as on the original board
+int build_board_layout(BoardLayout* layout, const Board* board, int width, int height) {
+    memset(layout, 0, sizeof(*layout));
+    if (board->cols > width || board->rows > height) {
+        printf("A %d x %d board does not fit on the screen!\n", board->rows, board->cols);
+        return 0;
+    }
+    
+    layout->rows = board->rows;
+    layout->cols = board->cols;
+    layout->squares = board->squares;
+    layout->cell_width = width / board->cols;
+    layout->cell_height = height / board->rows;
+    layout->cells = malloc(sizeof(SDL_Rect) * (board->squares + 1));
+    layout->tokens = malloc(sizeof(SDL_Point) * (board->squares + 1));
+    if (layout->cells == NULL || layout->tokens == NULL) {
+        printf("Out of memory for the board layout!\n");
+        free_board_layout(layout);
+        return 0;
+    }
+    
+    layout->cells[0] = (SDL_Rect){0, 0, 0, 0};
+    layout->tokens[0] = (SDL_Point){0, 0};
+    for (int square = 1; square <= board->squares; square++) {
+        int row = (square - 1) / board->cols;     // counted from the bottom
+        int col = (square - 1) % board->cols;
+        if (row % 2 == 0) col = board->cols - 1 - col; // Zigzag pattern
+        
+        SDL_Rect cell = {BOARD_X + col * layout->cell_width,
+                         BOARD_Y + (board->rows - 1 - row) * layout->cell_height,
+                         layout->cell_width, layout->cell_height};
+        layout->cells[square] = cell;
+        layout->tokens[square] = (SDL_Point){cell.x + cell.w / 2, cell.y + cell.h / 4};
+    }
+    return 1;
+}
+
+// Release a board layout
+void free_board_layout(BoardLayout* layout) {
+    free(layout->cells);
+    free(layout->tokens);
+    layout->cells = NULL;
+    layout->tokens = NULL;
+    layout->squares = 0;
+}
+
+// Draw everything on the board that never changes during a game
+void draw_board_static() {
     SDL_Color white = COLOR_WHITE;
     SDL_Color black = COLOR_BLACK;
+    int board_width = layout.cols * layout.cell_width;
+    int board_height = layout.rows * layout.cell_height;
     
     // Clear screen with blue background
     SDL_Color blue = COLOR_BLUE;
@@ -216,79 +1059,236 @@ void draw_board() {
     clear_screen();
     
     // Draw board outline
-    draw_rectangle(20, 0, BOARD_WIDTH, BOARD_HEIGHT, white);
-    
-    // Draw grid lines
-    for (int i = 1; i <= 9; i++) {
-        draw_line(20, 42 * i, 640, 42 * i, white);
-        delay_ms(100);
-    }
-    
-    for (int i = 1; i <= 9; i++) {
-        draw_line(64 * i, 0, 64 * i, BOARD_HEIGHT, white);
-        delay_ms(100);
-    }
-    
-    // Draw numbers on the board
-    int numbers[10][10] = {
-        {100, 99, 98, 97, 96, 95, 94, 93, 92, 91},
-        {90, 89, 88, 87, 86, 85, 84, 83, 82, 81},
-        {80, 79, 78, 77, 76, 75, 74, 73, 72, 71},
-        {70, 69, 68, 67, 66, 65, 64, 63, 62, 61},
-        {60, 59, 58, 57, 56, 55, 54, 53, 52, 51},
-        {50, 49, 48, 47, 46, 45, 44, 43, 42, 41},
-        {40, 39, 38, 37, 36, 35, 34, 33, 32, 31},
-        {30, 29, 28, 27, 26, 25, 24, 23, 22, 21},
-        {20, 19, 18, 17, 16, 15, 14, 13, 12, 11},
-        {10, 9, 8, 7, 6, 5, 4, 3, 2, 1}
-    };
-    
-    for (int row = 0; row < 10; row++) {
-        for (int col = 0; col < 10; col++) {
-            int x = 25 + col * 64;
-            int y = 15 + row * 42;
-            char num_str[4];
-            sprintf(num_str, "%d", numbers[row][col]);
-            draw_small_text(x, y, num_str, white);
+    draw_rectangle(BOARD_X, BOARD_Y, board_width, board_height, white);
+    
+    // Draw grid lines, unless the cells are too small to tell apart
+    if (layout.cell_height >= 3) {
+        for (int i = 1; i < layout.rows; i++) {
+            int y = BOARD_Y + i * layout.cell_height;
+            draw_line(BOARD_X, y, BOARD_X + board_width, y, white);
+        }
+    }
+    if (layout.cell_width >= 3) {
+        for (int i = 1; i < layout.cols; i++) {
+            int x = BOARD_X + i * layout.cell_width;
+            draw_line(x, BOARD_Y, x, BOARD_Y + board_height, white);
+        }
+    }
+    
+    // Draw numbers on the board where they fit
+    int label_height = small_text_atlas.glyphs['0' - FIRST_GLYPH].h;
+    if (label_height <= layout.cell_height) {
+        for (int square = 1; square <= layout.squares; square++) {
+            const SDL_Rect* cell = &layout.cells[square];
+            char num_str[16];
+            sprintf(num_str, "%d", square);
+            if (atlas_text_width(&small_text_atlas, num_str) + 5 > cell->w) continue;
+            draw_small_text(cell->x + 5, cell->y + (cell->h - label_height) / 2 + 4, num_str, white);
         }
-        delay_ms(200);
     }
     
     // Draw player indicators
-    SDL_Color yellow = COLOR_YELLOW;
-    SDL_Color orange = COLOR_ORANGE;
-    draw_filled_rectangle(5, 440, 48, 15, yellow);
-    draw_rectangle(5, 440, 48, 15, black);
-    draw_filled_rectangle(53, 440, 53, 15, orange);
-    draw_rectangle(53, 440, 53, 15, black);
-    draw_small_text(30, 435, "A", black);
-    draw_small_text(70, 435, "B", black);
+    for (int p = 0; p < num_players; p++) {
+        int x = 5 + p * LEGEND_BOX_WIDTH;
+        char label[2] = {(char)('A' + p), '\0'};
+        draw_filled_rectangle(x, 440, LEGEND_BOX_WIDTH, 15, player_color(p));
+        draw_rectangle(x, 440, LEGEND_BOX_WIDTH, 15, black);
+        draw_small_text(x + 25, 435, label, black);
+    }
+}
+
+// Render the static board once into a texture
+int render_board_texture() {
+    if (board_texture) return 1;
+    if (!SDL_RenderTargetSupported(renderer)) return 0;
     
-    SDL_RenderPresent(renderer);
+    board_texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_TARGET,
+                                      SCREEN_WIDTH, SCREEN_HEIGHT);
+    if (board_texture == NULL) return 0;
+    render_stats.frame_textures++;
+    
+    SDL_SetRenderTarget(renderer, board_texture);
+    draw_board_static();
+    SDL_SetRenderTarget(renderer, NULL);
+    return 1;
+}
+
+// Draw the game board
+void draw_board() {
+    if (render_board_texture()) {
+        SDL_RenderCopy(renderer, board_texture, NULL, NULL);
+        render_stats.frame_draw_calls++;
+    } else {
+        draw_board_static();
+    }
+    
+    present_frame();
+}
+
+// Token color of a player
+SDL_Color player_color(int player) {
+    SDL_Color colors[MAX_GUI_PLAYERS] = {COLOR_YELLOW, COLOR_ORANGE, COLOR_CYAN,
+                                         COLOR_MAGENTA, COLOR_PINK, COLOR_LIGHT_BLUE};
+    return colors[player % MAX_GUI_PLAYERS];
+}
+
+// Create the texture game frames are assembled in; it keeps the previous
+// frame so a move only repaints the regions it changed
+int render_frame_texture() {
+    if (frame_texture) return 1;
+    
+    frame_texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_TARGET,
+                                      SCREEN_WIDTH, SCREEN_HEIGHT);
+    frame_valid = 0;
+    if (frame_texture == NULL) return 0;
+    render_stats.frame_textures++;
+    return 1;
+}
+
+// Screen rectangle of a player's token on a square
+SDL_Rect token_rect(int player, int square) {
+    int x, y;
+    square_to_screen(square < layout.squares ? square : layout.squares, &x, &y);
+    return (SDL_Rect){x - (player % TOKENS_PER_ROW) * TOKEN_STEP_X,
+                      y + (player / TOKENS_PER_ROW) * TOKEN_STEP_Y, TOKEN_WIDTH, TOKEN_HEIGHT};
+}
+
+// Everything a change on a square can touch: its cell and any token on it
+SDL_Rect square_damage_rect(int square) {
+    SDL_Rect damage = layout.cells[square < layout.squares ? square : layout.squares];
+    for (int p = 0; p < num_players; p++) {
+        SDL_Rect token = token_rect(p, square);
+        SDL_UnionRect(&damage, &token, &damage);
+    }
+    return damage;
+}
+
+// Forget the previous game frame so the next one is drawn in full
+void invalidate_game_frame() {
+    frame_valid = 0;
+}
+
+// Draw the parts of a game frame that fall inside one region
+static void draw_frame_region(const SDL_Rect* region, const int32_t* positions, int flash_square,
+                              const char* status) {
+    SDL_RenderSetClipRect(renderer, region);
+    SDL_RenderCopy(renderer, board_texture, region, region);
+    render_stats.frame_draw_calls++;
+    
+    if (flash_square > 0) {
+        const SDL_Rect* cell = &layout.cells[flash_square];
+        if (SDL_HasIntersection(cell, region)) {
+            SDL_Color color;
+            int destination;
+            handle_snake_ladder(flash_square, &destination, &color);
+            draw_filled_rectangle(cell->x + 1, cell->y + 1, cell->w - 1, cell->h - 1, color);
+        }
+    }
+    
+    // Players sharing a square are staggered so every token stays visible
+    for (int p = 0; p < num_players; p++) {
+        if (positions[p] == 0) continue;
+        SDL_Rect token = token_rect(p, positions[p]);
+        if (SDL_HasIntersection(&token, region)) draw_player(token.x, token.y, player_color(p));
+    }
+    
+    if (status && region->y + region->h > STATUS_Y) {
+        draw_small_text(5 + num_players * LEGEND_BOX_WIDTH + 24, 435, status, COLOR_WHITE);
+    }
+    SDL_RenderSetClipRect(renderer, NULL);
+}
+
+// Draw one frame of a game: the board, every player on it, the square of a
+// snake or ladder being taken (0 for none) and a status line. Only the cells
+// that changed since the previous frame are repainted.
+void draw_game_frame(const int32_t* positions, int flash_square, const char* status) {
+    SDL_Rect dirty[MAX_DIRTY_RECTS];
+    int count = 0;
+    
+    if (!render_board_texture() || !render_frame_texture()) {
+        // No render targets: repaint everything straight to the screen
+        SDL_Rect screen = {0, 0, SCREEN_WIDTH, SCREEN_HEIGHT};
+        draw_board_static();
+        draw_frame_region(&screen, positions, flash_square, status);
+        present_frame();
+        return;
+    }
+    
+    if (!frame_valid) {
+        dirty[count++] = (SDL_Rect){0, 0, SCREEN_WIDTH, SCREEN_HEIGHT};
+    } else {
+        for (int p = 0; p < num_players; p++) {
+            if (positions[p] == frame_positions[p]) continue;
+            if (frame_positions[p] > 0) dirty[count++] = square_damage_rect(frame_positions[p]);
+            if (positions[p] > 0) dirty[count++] = square_damage_rect(positions[p]);
+        }
+        if (frame_flash > 0) dirty[count++] = square_damage_rect(frame_flash);
+        if (flash_square > 0) dirty[count++] = square_damage_rect(flash_square);
+        
+        int status_x = 5 + num_players * LEGEND_BOX_WIDTH;
+        dirty[count++] = (SDL_Rect){status_x, STATUS_Y, SCREEN_WIDTH - status_x, SCREEN_HEIGHT - STATUS_Y};
+    }
+    
+    SDL_SetRenderTarget(renderer, frame_texture);
+    for (int i = 0; i < count; i++) {
+        draw_frame_region(&dirty[i], positions, flash_square, status);
+    }
+    SDL_SetRenderTarget(renderer, NULL);
+    
+    // The back buffer is undefined after a present, so the whole assembled
+    // frame is copied; that is one copy whatever the board size
+    SDL_RenderCopy(renderer, frame_texture, NULL, NULL);
+    render_stats.frame_draw_calls++;
+    present_frame();
+    
+    memcpy(frame_positions, positions, sizeof(frame_positions[0]) * num_players);
+    frame_flash = flash_square;
+    frame_valid = 1;
 }
 
 // Draw player piece
 void draw_player(int x, int y, SDL_Color color) {
-    draw_filled_rectangle(x, y, 14, 10, color);
-    draw_rectangle(x, y, 14, 10, COLOR_BLACK);
+    draw_filled_rectangle(x, y, TOKEN_WIDTH, TOKEN_HEIGHT, color);
+    draw_rectangle(x, y, TOKEN_WIDTH, TOKEN_HEIGHT, COLOR_BLACK);
 }
 
-// Show main menu
-void show_menu() {
+// Draw one frame of the main menu, cycling the background color
+void draw_menu(int frame) {
     SDL_Color colors[] = {COLOR_RED, COLOR_GREEN, COLOR_BLUE, COLOR_YELLOW, COLOR_CYAN, 
                          COLOR_MAGENTA, COLOR_ORANGE, COLOR_PINK, COLOR_GRAY, COLOR_DARK_GRAY,
-                         COLOR_LIGHT_BLUE, COLOR_BROWN, COLOR_WHITE};
+                         COLOR_LIGHT_BLUE, COLOR_BROWN};
     
-    for (int i = 0; i < 13; i++) {
-        set_background_color(colors[i]);
-        clear_screen();
-        draw_text(320, 230, "1.WANT TO PLAY", COLOR_WHITE);
-        draw_text(320, 250, "2.GAME INSTRUCTION", COLOR_WHITE);
-        draw_text(320, 270, "3.QUIT", COLOR_WHITE);
-        draw_text(320, 290, "press the option", COLOR_WHITE);
-        SDL_RenderPresent(renderer);
-        delay_ms(500);
-    }
+    set_background_color(colors[frame % 12]);
+    clear_screen();
+    draw_text(MENU_X, MENU_Y, "1.WANT TO PLAY", COLOR_WHITE);
+    draw_text(MENU_X, MENU_Y + MENU_ROW_HEIGHT, "2.GAME INSTRUCTION", COLOR_WHITE);
+    draw_text(MENU_X, MENU_Y + 2 * MENU_ROW_HEIGHT, "3.QUIT", COLOR_WHITE);
+    draw_text(MENU_X, MENU_Y + 3 * MENU_ROW_HEIGHT, "press the option", COLOR_WHITE);
+    present_frame();
+}
+
+// Scheduled callback animating the menu while it waits for a choice
+static Uint32 animate_menu(void* data) {
+    int* frame = data;
+    draw_menu((*frame)++);
+    return 500;
+}
+
+// Show main menu and return the chosen option, or 0 on quit
+int show_menu() {
+    int frame = 0;
+    int choice = 0;
+    
+    printf("Enter your choice (1-3): ");
+    fflush(stdout);
+    
+    menu_active = 1;
+    int animation = schedule_callback(0, animate_menu, &frame);
+    if (!wait_for_input(&choice)) choice = 0;
+    cancel_callback(animation);
+    menu_active = 0;
+    
+    return choice;
 }
 
 // Show game instructions
@@ -298,18 +1298,20 @@ void show_instructions() {
     clear_screen();
     
     draw_text(50, 50, "GAME INSTRUCTIONS:", COLOR_WHITE);
-    draw_text(50, 80, "1. 2 PLAYERS MUST PLAY.", COLOR_WHITE);
+    char players_line[50];
+    sprintf(players_line, "1. %d PLAYERS MUST PLAY.", num_players);
+    draw_text(50, 80, players_line, COLOR_WHITE);
     draw_text(50, 100, "2. PLAYER SHOULD PUT HIS WILLING NUMBER WITH THE KEYBOARD.", COLOR_WHITE);
     draw_text(50, 120, "3. THAT NUMBER SHOULD BELONG >=1 AND <=6.", COLOR_WHITE);
     draw_text(50, 140, "4. IF THE PLAYER WILL PUT NUMBER IGNORING", COLOR_WHITE);
     draw_text(50, 160, "   THE INSTRUCTION THE HE WILL LOSS HIS CHANCE.", COLOR_WHITE);
-    draw_text(50, 180, "5. YOU SHOULD PRESS THE ENTER KEY AFTER YOU", COLOR_WHITE);
-    draw_text(50, 200, "   ENTERED THE NUMBER.", COLOR_WHITE);
+    draw_text(50, 180, "5. PRESS A NUMBER KEY 1-6 ON THE KEYBOARD OR KEYPAD;", COLOR_WHITE);
+    draw_text(50, 200, "   IT COUNTS AT ONCE, NO ENTER KEY IS NEEDED.", COLOR_WHITE);
     draw_text(50, 220, "6. THE SNAKES AND LADDERS ARE NOT SEEN TO THE", COLOR_WHITE);
     draw_text(50, 240, "   PLAYERS.", COLOR_WHITE);
     draw_text(320, 300, "READ PROPERLY", COLOR_WHITE);
     
-    SDL_RenderPresent(renderer);
+    present_frame();
     delay_ms(15000);
 }
 
@@ -324,65 +1326,14 @@ void show_credits() {
     draw_text(390, 340, " AJIT KUMAR BEHERA", COLOR_WHITE);
     draw_text(390, 360, "CLASS-IX", COLOR_WHITE);
     
-    SDL_RenderPresent(renderer);
+    present_frame();
     delay_ms(5000);
 }
 
 // Handle snake and ladder effects
 void handle_snake_ladder(int position, int* new_position, SDL_Color* effect_color) {
-    *new_position = position;
-    *effect_color = COLOR_RED; // Default to red for snakes
-    
-    switch (position) {
-        case 60: // Snake
-            *new_position = 30;
-            *effect_color = COLOR_RED;
-            break;
-        case 94: // Snake
-            *new_position = 1;
-            *effect_color = COLOR_RED;
-            break;
-        case 82: // Snake
-            *new_position = 17;
-            *effect_color = COLOR_RED;
-            break;
-        case 36: // Snake
-            *new_position = 7;
-            *effect_color = COLOR_RED;
-            break;
-        case 99: // Snake
-            *new_position = 3;
-            *effect_color = COLOR_RED;
-            break;
-        case 97: // Snake
-            *new_position = 32;
-            *effect_color = COLOR_RED;
-            break;
-        case 27: // Ladder
-            *new_position = 98;
-            *effect_color = COLOR_GREEN;
-            break;
-        case 43: // Ladder
-            *new_position = 66;
-            *effect_color = COLOR_GREEN;
-            break;
-        case 7: // Ladder
-            *new_position = 77;
-            *effect_color = COLOR_GREEN;
-            break;
-        case 33: // Ladder
-            *new_position = 85;
-            *effect_color = COLOR_GREEN;
-            break;
-        case 49: // Ladder
-            *new_position = 93;
-            *effect_color = COLOR_GREEN;
-            break;
-        case 14: // Ladder
-            *new_position = 61;
-            *effect_color = COLOR_GREEN;
-            break;
-    }
+    *new_position = board_jump(&board, position);
+    *effect_color = board.kind[position] == JUMP_LADDER ? COLOR_GREEN : COLOR_RED;
 }
 
 // Show winner message
@@ -396,117 +1347,163 @@ void show_winner(const char* player) {
     draw_text(320, 230, win_msg, COLOR_WHITE);
     draw_text(320, 270, "CONGRATULATION!", COLOR_WHITE);
     
-    SDL_RenderPresent(renderer);
+    present_frame();
     delay_ms(5000);
 }
 
-// Main game loop
+// Screen position of a player piece on the given square
+void square_to_screen(int position, int* x, int* y) {
+    *x = layout.tokens[position].x;
+    *y = layout.tokens[position].y;
+}
+
+// Worker thread: search one move for the computer player
+static int ai_worker(void* data) {
+    AiJob* job = data;
+    ai_choose_move(&ai_search, &job->state, 0, AI_BUDGET_MS, &job->result);
+    SDL_AtomicSet(&job->done, 1);
+    return 0;
+}
+
+// Pick the computer's number, searching on a worker thread while the frame
+// loop keeps handling events; returns 0 on quit
+int computer_roll(const Game* game) {
+    AiJob job;
+    memset(&job, 0, sizeof(job));
+    variant_init(&job.state);
+    job.state.current = game->current;
+    for (int player = 0; player < AI_PLAYERS; player++) job.state.position[player][0] = game->position[player];
+    
+    // Headless: the virtual clock does not wait, so search in place
+    SDL_Thread* thread = headless ? NULL : SDL_CreateThread(ai_worker, "ai_search", &job);
+    if (headless) {
+        ai_choose_move(&ai_search, &job.state, 0, 0, &job.result);
+    } else if (thread == NULL) {
+        ai_worker(&job);
+    } else {
+        while (!SDL_AtomicGet(&job.done) && delay_ms(AI_POLL_MS)) {
+        }
+        SDL_WaitThread(thread, NULL);
+    }
+    if (quit_requested) return 0;
+    
+    printf("Player %c enters %d (searched %d plies, %ld positions)\n", 'A' + game->current,
+           job.result.move.roll, job.result.depth, job.result.nodes);
+    return job.result.move.roll;
+}
+
+// Main game loop: drives the game's turn flow, showing each event it
+// suspends on and feeding it rolls from the input queue
 void play_game() {
-    int player_a_pos = 0, player_b_pos = 0;
-    int dice_roll;
-    SDL_Color yellow = COLOR_YELLOW;
-    SDL_Color orange = COLOR_ORANGE;
-    SDL_Color black = COLOR_BLACK;
+    TurnFlow flow;
+    char prompt[50];
     
-    draw_board();
+    turn_flow_init(&flow, num_players);
+    invalidate_game_frame();
     
-    while (1) {
-        // Process SDL events
-        SDL_Event event;
-        while (SDL_PollEvent(&event)) {
-            if (event.type == SDL_QUIT) {
-                return;
-            }
-        }
-        
-        // Player A's turn
-        printf("Player A's turn. Enter dice roll (1-6): ");
-        scanf("%d", &dice_roll);
+    TurnEvent event = turn_flow_resume(&flow, &board, 0);
+    while (event != TURN_GAME_OVER) {
+        int dice_roll = 0;
         
-        if (dice_roll >= 1 && dice_roll <= 6) {
-            player_a_pos += dice_roll;
-            
-            // Calculate board position
-            int row_a = 9 - (player_a_pos - 1) / 10;
-            int col_a = (player_a_pos - 1) % 10;
-            if (row_a % 2 == 1) col_a = 9 - col_a; // Zigzag pattern
-            
-            int x_a = 50 + col_a * 64;
-            int y_a = 10 + row_a * 42;
-            
-            // Draw player A
-            draw_player(x_a, y_a, yellow);
-            SDL_RenderPresent(renderer);
-            
-            // Check for snake/ladder
-            int new_pos_a;
-            SDL_Color effect_color_a;
-            handle_snake_ladder(player_a_pos, &new_pos_a, &effect_color_a);
-            
-            if (new_pos_a != player_a_pos) {
-                player_a_pos = new_pos_a;
-                // Redraw at new position
-                int new_row_a = 9 - (player_a_pos - 1) / 10;
-                int new_col_a = (player_a_pos - 1) % 10;
-                if (new_row_a % 2 == 1) new_col_a = 9 - new_col_a;
-                int new_x_a = 50 + new_col_a * 64;
-                int new_y_a = 10 + new_row_a * 42;
-                draw_player(new_x_a, new_y_a, yellow);
-                SDL_RenderPresent(renderer);
-            }
-            
-            if (player_a_pos >= 100) {
-                show_winner("PLAYER A");
-                return;
+        if (event == TURN_NEED_ROLL) {
+            if (flow.game.current == computer_player) {
+                sprintf(prompt, "PLAYER %c IS THINKING", 'A' + flow.game.current);
+                draw_game_frame(flow.game.position, 0, prompt);
+                dice_roll = computer_roll(&flow.game);
+                if (dice_roll == 0) {
+                    return;
+                }
+                event = turn_flow_resume(&flow, &board, dice_roll);
+                continue;
             }
-        }
-        
-        // Player B's turn
-        printf("Player B's turn. Enter dice roll (1-6): ");
-        scanf("%d", &dice_roll);
-        
-        if (dice_roll >= 1 && dice_roll <= 6) {
-            player_b_pos += dice_roll;
-            
-            // Calculate board position
-            int row_b = 9 - (player_b_pos - 1) / 10;
-            int col_b = (player_b_pos - 1) % 10;
-            if (row_b % 2 == 1) col_b = 9 - col_b; // Zigzag pattern
-            
-            int x_b = 50 + col_b * 64;
-            int y_b = 10 + row_b * 42;
             
-            // Draw player B
-            draw_player(x_b, y_b, orange);
-            SDL_RenderPresent(renderer);
-            
-            // Check for snake/ladder
-            int new_pos_b;
-            SDL_Color effect_color_b;
-            handle_snake_ladder(player_b_pos, &new_pos_b, &effect_color_b);
-            
-            if (new_pos_b != player_b_pos) {
-                player_b_pos = new_pos_b;
-                // Redraw at new position
-                int new_row_b = 9 - (player_b_pos - 1) / 10;
-                int new_col_b = (player_b_pos - 1) % 10;
-                if (new_row_b % 2 == 1) new_col_b = 9 - new_col_b;
-                int new_x_b = 50 + new_col_b * 64;
-                int new_y_b = 10 + new_row_b * 42;
-                draw_player(new_x_b, new_y_b, orange);
-                SDL_RenderPresent(renderer);
+            if (policy.entries) {
+                // Two players: the table is indexed by the mover's square first
+                int mover = flow.game.current;
+                sprintf(prompt, "PLAYER %c: PRESS 1-6 (BEST %d)", 'A' + mover,
+                        policy_best_roll(&policy, flow.game.position[mover], flow.game.position[1 - mover]));
+            } else {
+                sprintf(prompt, "PLAYER %c: PRESS 1-6", 'A' + flow.game.current);
             }
+            draw_game_frame(flow.game.position, 0, prompt);
             
-            if (player_b_pos >= 100) {
-                show_winner("PLAYER B");
+            printf("Player %c's turn. Enter dice roll (1-6): ", 'A' + flow.game.current);
+            fflush(stdout);
+            if (!wait_for_input(&dice_roll)) {
                 return;
             }
+        } else if (event == TURN_LANDED) {
+            // Show the piece where the roll landed before the snake or ladder
+            int32_t landed[MAX_PLAYERS];
+            memcpy(landed, flow.game.position, sizeof(landed));
+            landed[flow.turn.player] = flow.turn.landed;
+            draw_game_frame(landed, flow.turn.landed, NULL);
+            delay_ms(JUMP_FLASH_MS);
         }
+        
+        event = turn_flow_resume(&flow, &board, dice_roll);
     }
+    
+    sprintf(prompt, "PLAYER %c", 'A' + flow.game.winner);
+    show_winner(prompt);
 }
 
-// Main function
-int main() {
+// Main function (left out when the file is built into the benchmark)
+#ifndef SNAKE_LADDER_NO_MAIN
+int main(int argc, char** argv) {
+    const char* board_path = NULL;
+    
+    // Command line: [--players N] [--headless] [--frames DIR] [--stats FILE] [--hints] [--ai] [board file]
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--players") == 0 && i + 1 < argc) {
+            num_players = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--headless") == 0) {
+            headless = 1;
+        } else if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+            frame_dir = argv[++i];
+        } else if (strcmp(argv[i], "--stats") == 0 && i + 1 < argc) {
+            stats_path = argv[++i];
+        } else if (strcmp(argv[i], "--hints") == 0) {
+            show_hints = 1;
+        } else if (strcmp(argv[i], "--ai") == 0) {
+            computer_player = 1;
+        } else {
+            board_path = argv[i];
+        }
+    }
+    if (num_players < 2 || num_players > MAX_GUI_PLAYERS) {
+        printf("Number of players must be between 2 and %d!\n", MAX_GUI_PLAYERS);
+        return 1;
+    }
+    
+    if (board_path) {
+        if (!board_load(&board, board_path)) {
+            return 1;
+        }
+    } else if (!board_init_classic(&board)) {
+        return 1;
+    }
+    if (!build_board_layout(&layout, &board, BOARD_WIDTH, BOARD_HEIGHT)) {
+        return 1;
+    }
+    if (show_hints && num_players != 2) {
+        printf("Hints are only available in two-player games\n");
+    } else if (show_hints && !policy_solve(&board, &policy)) {
+        return 1;
+    }
+    if (computer_player >= 0) {
+        // The game's own rule: one token each, players choose their number
+        VariantRules rules = {1, 0, 0, 1};
+        if (num_players != 2) {
+            printf("The computer player needs a two-player game\n");
+            computer_player = -1;
+        } else if (!ai_init(&ai_search, &board, &rules, AI_DEFAULT_TABLE_ENTRIES)) {
+            return 1;
+        } else if (headless) {
+            ai_search.max_depth = AI_HEADLESS_DEPTH;
+        }
+    }
+    
     if (!init_graphics()) {
         printf("Failed to initialize graphics!\n");
         return 1;
@@ -514,12 +1511,15 @@ int main() {
     
     int choice;
     
+    start_stdin_reader();
+    if (stats_path) schedule_callback(STATS_DUMP_MS, dump_render_stats, (void*)stats_path);
+    
     // Welcome screen
     SDL_Color blue = COLOR_BLUE;
     set_background_color(blue);
     clear_screen();
     draw_text(230, 210, "WELCOME", COLOR_WHITE);
-    SDL_RenderPresent(renderer);
+    present_frame();
     delay_ms(2000);
     
     // Animated title
@@ -527,32 +1527,23 @@ int main() {
                          COLOR_MAGENTA, COLOR_ORANGE, COLOR_PINK, COLOR_GRAY, COLOR_DARK_GRAY,
                          COLOR_LIGHT_BLUE, COLOR_BROWN, COLOR_WHITE};
     
-    for (int i = 0; i < 13; i++) {
+    for (int i = 0; i < 13 && !quit_requested; i++) {
         set_background_color(colors[i]);
         clear_screen();
         draw_text(300 - i * 10, 200 - i * 10, "SNAKE & LADDERS", COLOR_WHITE);
-        SDL_RenderPresent(renderer);
+        present_frame();
         delay_ms(500);
     }
     
-    play_sound();
-    delay_ms(1000);
+    if (!quit_requested) {
+        play_sound();
+        delay_ms(1000);
+    }
     
     // Main menu loop
-    while (1) {
-        // Process SDL events
-        SDL_Event event;
-        while (SDL_PollEvent(&event)) {
-            if (event.type == SDL_QUIT) {
-                cleanup_graphics();
-                return 0;
-            }
-        }
-        
-        show_menu();
-        
-        printf("Enter your choice (1-3): ");
-        scanf("%d", &choice);
+    while (!quit_requested) {
+        choice = show_menu();
+        if (quit_requested) break;
         
         if (choice < 1 || choice > 3) {
             printf("Invalid choice! Please enter 1, 2, or 3.\n");
@@ -564,11 +1555,11 @@ int main() {
                 set_background_color(COLOR_MAGENTA);
                 clear_screen();
                 draw_text(250, 200, "BEST OF LUCK!", COLOR_WHITE);
-                SDL_RenderPresent(renderer);
-                delay_ms(2000);
+                present_frame();
+                if (!delay_ms(2000)) break;
                 
                 show_credits();
-                play_game();
+                if (!quit_requested) play_game();
                 break;
                 
             case 2: // Instructions
@@ -579,24 +1570,30 @@ int main() {
                 set_background_color(COLOR_GREEN);
                 clear_screen();
                 draw_text(320, 230, "THANK YOU", COLOR_WHITE);
-                SDL_RenderPresent(renderer);
+                present_frame();
                 delay_ms(3000);
                 
                 // Animated exit
-                for (int i = 0; i <= 640; i += 10) {
+                for (int i = 0; i <= 640 && !quit_requested; i += 10) {
                     set_background_color(colors[i / 10 % 13]);
                     clear_screen();
                     draw_filled_rectangle(i, 200, 100, 80, COLOR_WHITE);
                     draw_rectangle(i, 200, 100, 80, COLOR_BLACK);
-                    SDL_RenderPresent(renderer);
+                    present_frame();
                     delay_ms(5);
                 }
                 
-                cleanup_graphics();
-                return 0;
+                quit_requested = 1;
+                break;
         }
     }
     
+    if (stats_path) write_render_stats(stats_path);
     cleanup_graphics();
+    policy_free(&policy);
+    if (computer_player >= 0) ai_free(&ai_search);
+    free_board_layout(&layout);
+    board_free(&board);
     return 0;
 }
+#endif
@@ -0,0 +1,316 @@
+/*SNAKE & LADDER GAME - BOARD LAYOUT OPTIMIZER*/
+// Searches snake and ladder placements by simulated annealing. Every
+// candidate is scored exactly with the Markov analyzer, which takes about
+// 70 microseconds on the original board where a simulation precise enough to
+// compare two layouts would take seconds. Independent chains run on all
+// cores from per-chain seeds, so the result depends on the seed and the
+// number of chains but not on the thread count.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "snake_ladder_optimizer.h"
+#include "snake_ladder_markov.h"
+#include "snake_ladder_runner.h"
+
+// One annealing chain: its board and the same layout as a list of jumps
+typedef struct {
+    Board board;
+    int jumps;
+    int32_t* from;
+    int32_t* to;
+    int* ends;              // [square] = jumps ending on the square
+    int min_length;
+    uint64_t random;
+} Chain;
+
+// Per-run state of a parallel optimization
+typedef struct {
+    const OptimizerConfig* config;
+    const Board* start;
+    int jumps;
+    int32_t* best_from;     // chains * jumps entries
+    int32_t* best_to;
+    BoardScore* best_score; // one per chain
+    int* ok;                // one per chain
+} OptimizerJob;
+
+// Next number of a chain's xorshift64* stream
+static uint64_t next_random(Chain* chain) {
+    chain->random ^= chain->random >> 12;
+    chain->random ^= chain->random << 25;
+    chain->random ^= chain->random >> 27;
+    return chain->random * 0x2545F4914F6CDD1DULL;
+}
+
+// Uniform integer in [low, high]
+static int random_between(Chain* chain, int low, int high) {
+    return low + (int)((next_random(chain) >> 33) % (uint64_t)(high - low + 1));
+}
+
+// Uniform double in [0, 1)
+static double random_unit(Chain* chain) {
+    return (next_random(chain) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+// Score a board against the targets; lower is better
+int score_board(const OptimizerConfig* config, const Board* board, BoardScore* score) {
+    MarkovResult result;
+    int max_turns = MARKOV_TURNS_PER_SQUARE * board->squares;
+    if (max_turns < MARKOV_DEFAULT_MAX_TURNS) max_turns = MARKOV_DEFAULT_MAX_TURNS;
+
+    if (!markov_analyze(board, config->num_players, max_turns, &result)) return 0;
+
+    score->length = result.game_expected_turns;
+    score->variance = result.game_turns_variance;
+    score->advantage = result.win_probability[0] - 1.0 / config->num_players;
+    score->tail_mass = result.tail_mass;
+    markov_free(&result);
+
+    double error = (score->length - config->target_length) / config->target_length;
+    score->score = error * error;
+    if (config->target_variance > 0.0) {
+        error = (score->variance - config->target_variance) / config->target_variance;
+        score->score += error * error;
+    }
+    if (score->advantage > config->max_advantage) {
+        error = score->advantage - config->max_advantage;
+        score->score += OPTIMIZER_ADVANTAGE_WEIGHT * error * error;
+    }
+    score->score += OPTIMIZER_TAIL_WEIGHT * score->tail_mass;
+    return 1;
+}
+
+// Whether jump i could run from -> to without breaking the layout rules:
+// it keeps its kind and minimum length and stays off the last square, and
+// a moved end never lands where a jump starts or a moved start where any
+// jump starts or ends. Only the end that moves is checked, so a start
+// board that breaks the rules is still accepted.
+static int jump_fits(const Chain* chain, int i, int from, int to) {
+    const Board* board = &chain->board;
+    int snake = board->kind[chain->from[i]] == JUMP_SNAKE;
+
+    if (from < 1 || from >= board->squares || to < 1 || to >= board->squares) return 0;
+    if (snake ? to > from - chain->min_length : to < from + chain->min_length) return 0;
+    if (from != chain->from[i] && (board->kind[from] != JUMP_NONE || chain->ends[from] > 0)) return 0;
+    if (to != chain->to[i] && board->kind[to] != JUMP_NONE) return 0;
+    return 1;
+}
+
+// Move jump i on the board and in the jump list
+static void move_jump(Chain* chain, int i, int from, int to) {
+    Board* board = &chain->board;
+    uint8_t kind = board->kind[chain->from[i]];
+
+    board->dest[chain->from[i]] = chain->from[i];
+    board->kind[chain->from[i]] = JUMP_NONE;
+    chain->ends[chain->to[i]]--;
+
+    board->dest[from] = to;
+    board->kind[from] = kind;
+    chain->ends[to]++;
+    chain->from[i] = from;
+    chain->to[i] = to;
+}
+
+// A new square near the old one (within a row) or anywhere on the board
+static int propose_square(Chain* chain, int square) {
+    const Board* board = &chain->board;
+    if (next_random(chain) & 1) {
+        return square + random_between(chain, -board->cols, board->cols);
+    }
+    return random_between(chain, 1, board->squares - 1);
+}
+
+// Propose and apply a random move of one end of one jump; returns the jump
+// moved, or -1 if no valid move was found
+static int random_move(Chain* chain, int32_t* old_from, int32_t* old_to) {
+    for (int attempt = 0; attempt < OPTIMIZER_MOVE_ATTEMPTS; attempt++) {
+        int i = random_between(chain, 0, chain->jumps - 1);
+        int from = chain->from[i];
+        int to = chain->to[i];
+
+        if (next_random(chain) & 1) from = propose_square(chain, from);
+        else to = propose_square(chain, to);
+        if ((from == chain->from[i] && to == chain->to[i]) || !jump_fits(chain, i, from, to)) continue;
+
+        *old_from = chain->from[i];
+        *old_to = chain->to[i];
+        move_jump(chain, i, from, to);
+        return i;
+    }
+    return -1;
+}
+
+// Place a jump of the given kind at a random valid spot
+static int place_random_jump(Chain* chain, int i, JumpKind kind) {
+    Board* board = &chain->board;
+    int squares = board->squares;
+
+    for (int attempt = 0; attempt < OPTIMIZER_MOVE_ATTEMPTS * squares; attempt++) {
+        int from = random_between(chain, 1, squares - 1);
+        int to = random_between(chain, 1, squares - 1);
+        int snake = kind == JUMP_SNAKE;
+
+        if (snake ? to > from - chain->min_length : to < from + chain->min_length) continue;
+        if (board->kind[from] != JUMP_NONE || chain->ends[from] > 0 || board->kind[to] != JUMP_NONE) continue;
+
+        board->dest[from] = to;
+        board->kind[from] = kind;
+        chain->ends[to]++;
+        chain->from[i] = from;
+        chain->to[i] = to;
+        return 1;
+    }
+    return 0;
+}
+
+// Release a chain
+static void free_chain(Chain* chain) {
+    board_free(&chain->board);
+    free(chain->from);
+    free(chain->to);
+    free(chain->ends);
+}
+
+// Set a chain up on the start board's size, with its layout or a random one
+static int init_chain(Chain* chain, const OptimizerConfig* config, const Board* start, long index,
+                      int jumps) {
+    memset(chain, 0, sizeof(*chain));
+    chain->random = game_seed(config->seed, index) | 1;
+    chain->jumps = jumps;
+    chain->min_length = start->cols / 2 > 1 ? start->cols / 2 : 1;
+    chain->from = malloc(sizeof(int32_t) * (jumps > 0 ? jumps : 1));
+    chain->to = malloc(sizeof(int32_t) * (jumps > 0 ? jumps : 1));
+    chain->ends = calloc(start->squares + DICE_SIDES, sizeof(int));
+    if (!board_init(&chain->board, start->rows, start->cols) ||
+        !chain->from || !chain->to || !chain->ends) {
+        free_chain(chain);
+        return 0;
+    }
+
+    int i = 0;
+    if (config->snakes == 0 && config->ladders == 0) {
+        for (int square = 1; square < start->squares; square++) {
+            if (start->kind[square] == JUMP_NONE) continue;
+            chain->board.dest[square] = start->dest[square];
+            chain->board.kind[square] = start->kind[square];
+            chain->ends[start->dest[square]]++;
+            chain->from[i] = square;
+            chain->to[i] = start->dest[square];
+            i++;
+        }
+        return 1;
+    }
+
+    for (; i < jumps; i++) {
+        if (!place_random_jump(chain, i, i < config->snakes ? JUMP_SNAKE : JUMP_LADDER)) {
+            printf("Could not fit %d snakes and %d ladders on the board!\n", config->snakes, config->ladders);
+            free_chain(chain);
+            return 0;
+        }
+    }
+    return 1;
+}
+
+// Run one annealing chain and keep the best layout it visits
+static void anneal_chain(void* context, int worker, long index) {
+    OptimizerJob* job = context;
+    const OptimizerConfig* config = job->config;
+    int32_t* best_from = job->best_from + index * job->jumps;
+    int32_t* best_to = job->best_to + index * job->jumps;
+    BoardScore* best = &job->best_score[index];
+    BoardScore current, candidate;
+    Chain chain;
+
+    (void)worker;
+    job->ok[index] = 0;
+    if (!init_chain(&chain, config, job->start, index, job->jumps)) return;
+    if (!score_board(config, &chain.board, &current)) {
+        free_chain(&chain);
+        return;
+    }
+    *best = current;
+    memcpy(best_from, chain.from, sizeof(int32_t) * job->jumps);
+    memcpy(best_to, chain.to, sizeof(int32_t) * job->jumps);
+
+    double cooling = config->iterations > 1
+        ? pow(OPTIMIZER_END_TEMPERATURE / OPTIMIZER_START_TEMPERATURE, 1.0 / (config->iterations - 1))
+        : 1.0;
+    double temperature = OPTIMIZER_START_TEMPERATURE;
+
+    for (long step = 0; step < config->iterations && job->jumps > 0; step++, temperature *= cooling) {
+        int32_t old_from, old_to;
+        int moved = random_move(&chain, &old_from, &old_to);
+        if (moved < 0) continue;
+
+        // A chain whose board could not be scored fails the whole search
+        if (!score_board(config, &chain.board, &candidate)) {
+            free_chain(&chain);
+            return;
+        }
+        if (candidate.score <= current.score ||
+            random_unit(&chain) < exp((current.score - candidate.score) / temperature)) {
+            current = candidate;
+            if (current.score < best->score) {
+                *best = current;
+                memcpy(best_from, chain.from, sizeof(int32_t) * job->jumps);
+                memcpy(best_to, chain.to, sizeof(int32_t) * job->jumps);
+            }
+        } else {
+            move_jump(&chain, moved, old_from, old_to);
+        }
+    }
+
+    free_chain(&chain);
+    job->ok[index] = 1;
+}
+
+// Search layouts on the start board's size for the one closest to the
+// targets and build it into best, which must not be set up yet
+int optimize_board(const OptimizerConfig* config, const Board* start, int threads,
+                   Board* best, BoardScore* best_score) {
+    int jumps = config->snakes + config->ladders;
+    if (jumps == 0) {
+        for (int square = 1; square < start->squares; square++) {
+            if (start->kind[square] != JUMP_NONE) jumps++;
+        }
+    }
+    if (config->chains < 1 || config->iterations < 0 || config->target_length <= 0.0) {
+        printf("Invalid optimizer settings!\n");
+        return 0;
+    }
+
+    OptimizerJob job = {config, start, jumps,
+                        malloc(sizeof(int32_t) * config->chains * (jumps > 0 ? jumps : 1)),
+                        malloc(sizeof(int32_t) * config->chains * (jumps > 0 ? jumps : 1)),
+                        calloc(config->chains, sizeof(BoardScore)),
+                        calloc(config->chains, sizeof(int))};
+    int ok = job.best_from && job.best_to && job.best_score && job.ok;
+    if (!ok) printf("Out of memory in board optimizer!\n");
+
+    if (ok) ok = run_parallel_chunks(config->chains, threads, anneal_chain, &job);
+
+    // Lowest score wins, ties going to the lowest chain
+    int winner = -1;
+    for (int c = 0; ok && c < config->chains; c++) {
+        if (!job.ok[c]) {
+            ok = 0;
+        } else if (winner < 0 || job.best_score[c].score < job.best_score[winner].score) {
+            winner = c;
+        }
+    }
+
+    if (ok) ok = board_init(best, start->rows, start->cols);
+    for (int i = 0; ok && i < jumps; i++) {
+        ok = board_add_jump(best, job.best_from[winner * jumps + i], job.best_to[winner * jumps + i]);
+        if (!ok) board_free(best);
+    }
+    if (ok) *best_score = job.best_score[winner];
+
+    free(job.best_from);
+    free(job.best_to);
+    free(job.best_score);
+    free(job.ok);
+    return ok;
+}
@@ -0,0 +1,49 @@
+/*SNAKE & LADDER GAME - BOARD LAYOUT OPTIMIZER*/
+#ifndef SNAKE_LADDER_OPTIMIZER_H
+#define SNAKE_LADDER_OPTIMIZER_H
+
+#include "snake_ladder_core.h"
+
+// Annealing schedule: candidates per chain and the temperature falling
+// geometrically from start to end
+#define OPTIMIZER_DEFAULT_ITERATIONS 5000
+#define OPTIMIZER_DEFAULT_CHAINS 8
+#define OPTIMIZER_DEFAULT_ADVANTAGE 0.02
+#define OPTIMIZER_START_TEMPERATURE 0.05
+#define OPTIMIZER_END_TEMPERATURE 1e-6
+
+// Tries at finding a valid move before a step is skipped
+#define OPTIMIZER_MOVE_ATTEMPTS 64
+
+// Weights of the soft constraints relative to the squared relative error
+// of the targets
+#define OPTIMIZER_ADVANTAGE_WEIGHT 100.0
+#define OPTIMIZER_TAIL_WEIGHT 1e6
+
+// What the optimizer aims for
+typedef struct {
+    int num_players;
+    int snakes;                 // 0 and 0 start from the given board's layout
+    int ladders;
+    double target_length;       // expected game length, turns by all players
+    double target_variance;     // 0 leaves the variance free
+    double max_advantage;       // first player's win probability above 1/players
+    long iterations;            // per chain
+    int chains;                 // independent annealing runs, best one wins
+    uint64_t seed;
+} OptimizerConfig;
+
+// Exact metrics of a board and how far they are from the targets
+typedef struct {
+    double score;               // 0 when every target is met exactly
+    double length;
+    double variance;
+    double advantage;
+    double tail_mass;
+} BoardScore;
+
+int score_board(const OptimizerConfig* config, const Board* board, BoardScore* score);
+int optimize_board(const OptimizerConfig* config, const Board* start, int threads,
+                   Board* best, BoardScore* best_score);
+
+#endif
@@ -0,0 +1,261 @@
+/*SNAKE & LADDER GAME - CHOOSE-YOUR-ROLL POLICY SOLVER*/
+// In the shipped game each player types the number they want to move, so a
+// two-player game is a deterministic race. It is solved backwards from the
+// finish (retrograde analysis): a state where the mover can finish this
+// turn is won in one ply, a state with a move into a lost state is won one
+// ply later than that state, and a state whose every move leads to a won
+// state is lost one ply later than the slowest of them. States are visited
+// in order of depth, so wins get their fastest line and losses their
+// slowest. Whatever is never reached can be played forever: a draw.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "snake_ladder_policy.h"
+
+// Squares a move can come from, for every square it can reach
+typedef struct {
+    int* row_start;         // squares + 1 entries
+    int* source;            // one entry per non-finishing (square, roll)
+} Predecessors;
+
+// Build the reverse move lists of a board; finishing moves are left out
+static int build_predecessors(const Board* board, Predecessors* pred) {
+    int squares = board->squares;
+
+    pred->row_start = calloc(squares + 1, sizeof(int));
+    pred->source = malloc(sizeof(int) * squares * DICE_SIDES);
+    int* fill = malloc(sizeof(int) * (squares + 1));
+    if (!pred->row_start || !pred->source || !fill) {
+        free(pred->row_start);
+        free(pred->source);
+        free(fill);
+        return 0;
+    }
+
+    for (int square = 0; square < squares; square++) {
+        for (int roll = 1; roll <= DICE_SIDES; roll++) {
+            int to = board_jump(board, square + roll);
+            if (to < squares) pred->row_start[to + 1]++;
+        }
+    }
+    for (int square = 0; square < squares; square++) {
+        pred->row_start[square + 1] += pred->row_start[square];
+    }
+    memcpy(fill, pred->row_start, sizeof(int) * (squares + 1));
+    for (int square = 0; square < squares; square++) {
+        for (int roll = 1; roll <= DICE_SIDES; roll++) {
+            int to = board_jump(board, square + roll);
+            if (to < squares) pred->source[fill[to]++] = square;
+        }
+    }
+
+    free(fill);
+    return 1;
+}
+
+// Pick the roll that realizes a solved state's outcome: the fastest win,
+// the slowest loss, or a move that keeps a draw going
+static int best_roll(const Board* board, const uint8_t* outcome, const int* depth, int mover, int other) {
+    int squares = board->squares;
+    long state = (long)mover * squares + other;
+    int best = 0, best_depth = -1;
+
+    for (int roll = 1; roll <= DICE_SIDES; roll++) {
+        int to = board_jump(board, mover + roll);
+        if (to >= squares) {
+            if (outcome[state] == POLICY_WIN && depth[state] == 1) return roll;
+            continue;
+        }
+
+        long next = (long)other * squares + to;
+        switch (outcome[state]) {
+            case POLICY_WIN:
+                if (outcome[next] == POLICY_LOSS && depth[next] == depth[state] - 1) return roll;
+                break;
+            case POLICY_LOSS:
+                if (depth[next] > best_depth) {
+                    best = roll;
+                    best_depth = depth[next];
+                }
+                break;
+            case POLICY_DRAW:
+                if (outcome[next] == POLICY_DRAW) return roll;
+                break;
+        }
+    }
+    return best;
+}
+
+// Solve every (mover, other) state of a two-player choose-your-roll game
+int policy_solve(const Board* board, PolicyTable* table) {
+    int squares = board->squares;
+    long states = (long)squares * squares;
+    Predecessors pred;
+
+    memset(table, 0, sizeof(*table));
+    if (squares > POLICY_MAX_SQUARES) {
+        printf("Boards over %d squares are too large for a policy table!\n", POLICY_MAX_SQUARES);
+        return 0;
+    }
+
+    table->squares = squares;
+    table->board_hash = board_hash(board);
+    table->entries = malloc(states);
+    uint8_t* outcome = calloc(states, 1);
+    uint8_t* remaining = malloc(states);
+    int* depth = calloc(states, sizeof(int));
+    int* queue = malloc(sizeof(int) * states);
+    int ok = table->entries && outcome && remaining && depth && queue && build_predecessors(board, &pred);
+    if (!ok) {
+        printf("Out of memory in policy solver!\n");
+        free(outcome);
+        free(remaining);
+        free(depth);
+        free(queue);
+        policy_free(table);
+        return 0;
+    }
+
+    // Wins in one ply: the mover can finish from here
+    long head = 0, tail = 0;
+    for (int mover = 0; mover < squares; mover++) {
+        int finishes = 0;
+        for (int roll = 1; roll <= DICE_SIDES; roll++) {
+            if (board_jump(board, mover + roll) >= squares) finishes = 1;
+        }
+        for (int other = 0; other < squares; other++) {
+            long state = (long)mover * squares + other;
+            remaining[state] = DICE_SIDES;
+            if (finishes) {
+                outcome[state] = POLICY_WIN;
+                depth[state] = 1;
+                queue[tail++] = (int)state;
+            }
+        }
+    }
+
+    // A state (mover, other) moves to (other, landing); so the states that
+    // move into (a, b) are (m, a) for every m with a move to b
+    while (head < tail) {
+        long solved = queue[head++];
+        int a = (int)(solved / squares);
+        int b = (int)(solved % squares);
+
+        for (int k = pred.row_start[b]; k < pred.row_start[b + 1]; k++) {
+            long state = (long)pred.source[k] * squares + a;
+            if (outcome[state] != POLICY_DRAW) continue;
+
+            if (outcome[solved] == POLICY_LOSS) {
+                outcome[state] = POLICY_WIN;
+            } else if (--remaining[state] == 0) {
+                outcome[state] = POLICY_LOSS;
+            } else {
+                continue;
+            }
+            depth[state] = depth[solved] + 1;
+            queue[tail++] = (int)state;
+        }
+    }
+
+    for (int mover = 0; mover < squares; mover++) {
+        for (int other = 0; other < squares; other++) {
+            long state = (long)mover * squares + other;
+            table->entries[state] = (uint8_t)(best_roll(board, outcome, depth, mover, other) |
+                                              outcome[state] << POLICY_OUTCOME_SHIFT);
+        }
+    }
+
+    free(pred.row_start);
+    free(pred.source);
+    free(outcome);
+    free(remaining);
+    free(depth);
+    free(queue);
+    return 1;
+}
+
+// Release a policy table
+void policy_free(PolicyTable* table) {
+    free(table->entries);
+    table->entries = NULL;
+}
+
+// Little-endian stores and loads of header fields
+static void put_le(uint8_t* bytes, uint64_t value, int size) {
+    for (int i = 0; i < size; i++) bytes[i] = (uint8_t)(value >> (8 * i));
+}
+
+static uint64_t get_le(const uint8_t* bytes, int size) {
+    uint64_t value = 0;
+    for (int i = 0; i < size; i++) value |= (uint64_t)bytes[i] << (8 * i);
+    return value;
+}
+
+// Encode a cache header into its on-disk layout
+static void encode_header(const PolicyHeader* header, uint8_t* bytes) {
+    memcpy(bytes, header->magic, 4);
+    put_le(bytes + 4, header->version, 4);
+    put_le(bytes + 8, header->squares, 4);
+    put_le(bytes + 12, header->reserved, 4);
+    put_le(bytes + 16, header->board_hash, 8);
+}
+
+// Decode a cache header from its on-disk layout
+static void decode_header(const uint8_t* bytes, PolicyHeader* header) {
+    memcpy(header->magic, bytes, 4);
+    header->version = (uint32_t)get_le(bytes + 4, 4);
+    header->squares = (uint32_t)get_le(bytes + 8, 4);
+    header->reserved = (uint32_t)get_le(bytes + 12, 4);
+    header->board_hash = get_le(bytes + 16, 8);
+}
+
+// Write a policy table to a cache file
+int policy_save(const PolicyTable* table, const char* path) {
+    PolicyHeader header;
+    uint8_t bytes[POLICY_HEADER_BYTES];
+    long states = (long)table->squares * table->squares;
+
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, POLICY_MAGIC, 4);
+    header.version = POLICY_VERSION;
+    header.squares = (uint32_t)table->squares;
+    header.board_hash = table->board_hash;
+    encode_header(&header, bytes);
+
+    FILE* file = fopen(path, "wb");
+    if (file == NULL) {
+        printf("Could not create %s!\n", path);
+        return 0;
+    }
+    int ok = fwrite(bytes, sizeof(bytes), 1, file) == 1 &&
+             fwrite(table->entries, 1, states, file) == (size_t)states;
+    if (fclose(file) != 0) ok = 0;
+    if (!ok) printf("Could not write %s!\n", path);
+    return ok;
+}
+
+// Read a cached policy table; fails quietly if the file is missing or was
+// solved for another board
+int policy_load(PolicyTable* table, const Board* board, const char* path) {
+    PolicyHeader header;
+    uint8_t bytes[POLICY_HEADER_BYTES];
+    long states = (long)board->squares * board->squares;
+
+    memset(table, 0, sizeof(*table));
+    FILE* file = fopen(path, "rb");
+    if (file == NULL) return 0;
+
+    int ok = fread(bytes, sizeof(bytes), 1, file) == 1;
+    if (ok) decode_header(bytes, &header);
+    ok = ok && memcmp(header.magic, POLICY_MAGIC, 4) == 0 && header.version == POLICY_VERSION &&
+         header.squares == (uint32_t)board->squares && header.board_hash == board_hash(board);
+    if (ok) {
+        table->squares = board->squares;
+        table->board_hash = header.board_hash;
+        table->entries = malloc(states);
+        ok = table->entries != NULL && fread(table->entries, 1, states, file) == (size_t)states;
+    }
+    fclose(file);
+    if (!ok) policy_free(table);
+    return ok;
+}
@@ -0,0 +1,61 @@
+/*SNAKE & LADDER GAME - CHOOSE-YOUR-ROLL POLICY SOLVER*/
+#ifndef SNAKE_LADDER_POLICY_H
+#define SNAKE_LADDER_POLICY_H
+
+#include "snake_ladder_core.h"
+
+// Largest board solved: the table has squares * squares entries
+#define POLICY_MAX_SQUARES 4096
+
+// Policy cache file: header, then one byte per state. The header fields
+// are little-endian and packed in the order of PolicyHeader, and are
+// encoded field by field so a cache reads the same on any host.
+#define POLICY_MAGIC "SLPL"
+#define POLICY_VERSION 1
+#define POLICY_HEADER_BYTES 24
+
+// Outcome of a state for the player about to move, with perfect play
+typedef enum {
+    POLICY_DRAW = 0,            // neither side can force a finish
+    POLICY_WIN,
+    POLICY_LOSS
+} PolicyOutcome;
+
+// One entry per (mover, other) state: bits 0-2 hold the best roll, bits
+// 3-4 the outcome. The two players' roles swap every turn, so (position of
+// A, position of B, whose turn) needs only the mover's and the other's
+// positions.
+#define POLICY_ROLL_MASK 0x07
+#define POLICY_OUTCOME_SHIFT 3
+
+typedef struct {
+    int squares;
+    uint64_t board_hash;
+    uint8_t* entries;           // [mover * squares + other]
+} PolicyTable;
+
+// Header of a policy cache file
+typedef struct {
+    char magic[4];
+    uint32_t version;
+    uint32_t squares;
+    uint32_t reserved;
+    uint64_t board_hash;
+} PolicyHeader;
+
+int policy_solve(const Board* board, PolicyTable* table);
+void policy_free(PolicyTable* table);
+int policy_save(const PolicyTable* table, const char* path);
+int policy_load(PolicyTable* table, const Board* board, const char* path);
+
+// Best roll for the player to move, 1-6 (0 when no state applies)
+static inline int policy_best_roll(const PolicyTable* table, int mover, int other) {
+    return table->entries[(long)mover * table->squares + other] & POLICY_ROLL_MASK;
+}
+
+// Outcome for the player to move
+static inline PolicyOutcome policy_outcome(const PolicyTable* table, int mover, int other) {
+    return (PolicyOutcome)(table->entries[(long)mover * table->squares + other] >> POLICY_OUTCOME_SHIFT);
+}
+
+#endif
@@ -0,0 +1,283 @@
+/*SNAKE & LADDER GAME - BITBOARD REACHABILITY*/
+// Sets of squares are bitsets, so one turn for every square at once is six
+// shifts, an OR and a remap of the few squares that start a snake or
+// ladder. The original board fits one 128-bit value with room for
+// overshooting rolls; larger boards use arrays of 64-bit words.
+//
+// Searching forward from one square gives its fewest rolls to finish.
+// Searching backward from the finish, with the shifts reversed, gives every
+// square's at once, and from that table all the optimal roll sequences
+// follow by a walk that only takes rolls keeping to the minimum.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "snake_ladder_reach.h"
+
+typedef unsigned __int128 Bits128;
+
+// Whether a square is in a set
+static inline int test_bit(const uint64_t* set, int square) {
+    return (int)((set[square >> 6] >> (square & 63)) & 1);
+}
+
+// Add a square to a set
+static inline void set_bit(uint64_t* set, int square) {
+    set[square >> 6] |= 1ULL << (square & 63);
+}
+
+// out = every square one roll after a square of in
+static void shift_up_rolls(uint64_t* out, const uint64_t* in, int words) {
+    for (int w = 0; w < words; w++) {
+        uint64_t word = 0;
+        for (int roll = 1; roll <= DICE_SIDES; roll++) {
+            word |= in[w] << roll;
+            if (w > 0) word |= in[w - 1] >> (64 - roll);
+        }
+        out[w] = word;
+    }
+}
+
+// out = every square one roll before a square of in
+static void shift_down_rolls(uint64_t* out, const uint64_t* in, int words) {
+    for (int w = 0; w < words; w++) {
+        uint64_t word = 0;
+        for (int roll = 1; roll <= DICE_SIDES; roll++) {
+            word |= in[w] >> roll;
+            if (w + 1 < words) word |= in[w + 1] << (64 - roll);
+        }
+        out[w] = word;
+    }
+}
+
+// Load a set of at most 128 squares into one value
+static inline Bits128 load_bits128(const uint64_t* set, int words) {
+    return words > 1 ? (Bits128)set[1] << 64 | set[0] : set[0];
+}
+
+// Release a board's masks
+void reach_board_free(ReachBoard* masks) {
+    free(masks->from);
+    free(masks->starts);
+}
+
+// Build the masks and jump list of a board, once per board
+int reach_board_init(ReachBoard* masks, const Board* board) {
+    int squares = board->squares;
+
+    memset(masks, 0, sizeof(*masks));
+    masks->squares = squares;
+    masks->words = (squares + DICE_SIDES + 63) / 64;
+    for (int square = 1; square < squares; square++) {
+        if (board->kind[square] != JUMP_NONE) masks->jumps++;
+    }
+
+    masks->from = malloc(sizeof(int32_t) * 2 * (masks->jumps + 1));
+    masks->starts = calloc((size_t)masks->words * 6, sizeof(uint64_t));
+    if (masks->from == NULL || masks->starts == NULL) {
+        printf("Out of memory in reachability search!\n");
+        reach_board_free(masks);
+        return 0;
+    }
+    masks->to = masks->from + masks->jumps + 1;
+    masks->finish = masks->starts + masks->words;
+    masks->standing = masks->finish + masks->words;
+    for (int i = 0; i < 3; i++) masks->scratch[i] = masks->standing + masks->words * (i + 1);
+
+    int jump = 0;
+    for (int square = 0; square < masks->words * 64; square++) {
+        if (square >= squares) {
+            set_bit(masks->finish, square);
+        } else if (board->kind[square] != JUMP_NONE) {
+            set_bit(masks->starts, square);
+            masks->from[jump] = square;
+            masks->to[jump] = board->dest[square] < squares ? board->dest[square] : squares;
+            jump++;
+        } else {
+            set_bit(masks->standing, square);
+        }
+    }
+    // A jump is taken once, so a snake may leave a piece on a ladder's foot
+    for (int j = 0; j < masks->jumps; j++) {
+        if (masks->to[j] < squares) set_bit(masks->standing, masks->to[j]);
+    }
+    return 1;
+}
+
+// Forward search on one 128-bit set per turn
+static int min_rolls_128(const ReachBoard* masks, int start) {
+    Bits128 starts = load_bits128(masks->starts, masks->words);
+    Bits128 finish = load_bits128(masks->finish, masks->words);
+    Bits128 reach = (Bits128)1 << start;
+
+    for (int rolls = 1; rolls <= masks->squares; rolls++) {
+        Bits128 next = reach << 1 | reach << 2 | reach << 3 | reach << 4 | reach << 5 | reach << 6;
+        Bits128 jumped = 0;
+        for (int j = 0; j < masks->jumps; j++) {
+            jumped |= (next >> masks->from[j] & 1) << masks->to[j];
+        }
+        reach = (next & ~starts) | jumped;
+        if (reach & finish) return rolls;
+    }
+    return -1;
+}
+
+// Forward search on sets of any size
+static int min_rolls_words(const ReachBoard* masks, int start) {
+    uint64_t* reach = masks->scratch[0];
+    uint64_t* next = masks->scratch[1];
+    uint64_t* jumped = masks->scratch[2];
+    int words = masks->words;
+
+    memset(reach, 0, sizeof(uint64_t) * words);
+    set_bit(reach, start);
+    for (int rolls = 1; rolls <= masks->squares; rolls++) {
+        shift_up_rolls(next, reach, words);
+        memset(jumped, 0, sizeof(uint64_t) * words);
+        for (int j = 0; j < masks->jumps; j++) {
+            if (test_bit(next, masks->from[j])) set_bit(jumped, masks->to[j]);
+        }
+
+        uint64_t done = 0;
+        for (int w = 0; w < words; w++) {
+            reach[w] = (next[w] & ~masks->starts[w]) | jumped[w];
+            done |= reach[w] & masks->finish[w];
+        }
+        if (done) return rolls;
+    }
+    return -1;
+}
+
+// Fewest rolls to finish from a square, or -1 if it never can
+int reach_min_rolls(ReachBoard* masks, int start) {
+    if (start >= masks->squares) return 0;
+    return masks->words * 64 <= REACH_WIDE_BITS ? min_rolls_128(masks, start)
+                                                : min_rolls_words(masks, start);
+}
+
+// Fewest rolls to finish from every square, by a backward search: after
+// k rounds, known holds every square that can finish in k rolls or fewer
+int reach_solve(ReachBoard* masks, ReachTable* table) {
+    memset(table, 0, sizeof(*table));
+    table->squares = masks->squares;
+    table->min_rolls = malloc(sizeof(int) * masks->squares);
+    if (table->min_rolls == NULL) {
+        printf("Out of memory in reachability search!\n");
+        return 0;
+    }
+    for (int square = 0; square < masks->squares; square++) table->min_rolls[square] = -1;
+
+    uint64_t* known = masks->scratch[0];
+    uint64_t* landing = masks->scratch[1];
+    uint64_t* before = masks->scratch[2];
+    int words = masks->words;
+    memset(known, 0, sizeof(uint64_t) * words);
+
+    for (int rolls = 1; rolls <= masks->squares; rolls++) {
+        // Squares a roll may land on and still finish in rolls - 1 more:
+        // the finish, known squares that move nobody on, and jumps leading
+        // to either
+        for (int w = 0; w < words; w++) landing[w] = (known[w] & ~masks->starts[w]) | masks->finish[w];
+        for (int j = 0; j < masks->jumps; j++) {
+            if (masks->to[j] >= masks->squares || test_bit(known, masks->to[j])) {
+                set_bit(landing, masks->from[j]);
+            }
+        }
+        shift_down_rolls(before, landing, words);
+
+        uint64_t found = 0;
+        for (int w = 0; w < words; w++) {
+            uint64_t fresh = before[w] & masks->standing[w] & ~known[w];
+            known[w] |= fresh;
+            found |= fresh;
+            while (fresh) {
+                table->min_rolls[w * 64 + __builtin_ctzll(fresh)] = rolls;
+                fresh &= fresh - 1;
+            }
+        }
+        if (!found) break;
+        table->max_rolls = rolls;
+    }
+
+    return 1;
+}
+
+// Release a reachability table
+void reach_free(ReachTable* table) {
+    free(table->min_rolls);
+    table->min_rolls = NULL;
+}
+
+// Where a roll from a square ends up, and whether it stays on an optimal
+// path; rolls_left is the square's minimum
+static int optimal_roll(const Board* board, const ReachTable* table, int square, int roll,
+                        int rolls_left, int* next) {
+    *next = board_jump(board, square + roll);
+    if (*next >= board->squares) return rolls_left == 1;
+    return table->min_rolls[*next] == rolls_left - 1;
+}
+
+// Number of roll sequences finishing from a square in its fewest rolls,
+// saturating at LONG_MAX
+long reach_count_sequences(const Board* board, const ReachTable* table, int start) {
+    if (start >= board->squares) return 1;
+    int rolls_left = table->min_rolls[start];
+    if (rolls_left < 0) return 0;
+
+    // Squares by distance to the finish are counted nearest first
+    long* ways = calloc(board->squares, sizeof(long));
+    if (ways == NULL) {
+        printf("Out of memory in reachability search!\n");
+        return -1;
+    }
+    for (int distance = 1; distance <= rolls_left; distance++) {
+        for (int square = 0; square < board->squares; square++) {
+            if (table->min_rolls[square] != distance) continue;
+            for (int roll = 1; roll <= DICE_SIDES; roll++) {
+                int next;
+                if (!optimal_roll(board, table, square, roll, distance, &next)) continue;
+                long add = next >= board->squares ? 1 : ways[next];
+                ways[square] = ways[square] > __LONG_MAX__ - add ? __LONG_MAX__ : ways[square] + add;
+            }
+        }
+    }
+
+    long count = ways[start];
+    free(ways);
+    return count;
+}
+
+// Depth-first walk over optimal rolls
+static void list_from(const Board* board, const ReachTable* table, int square, int* rolls,
+                      int depth, long limit, long* found, RollSequenceFunction function, void* context) {
+    int rolls_left = table->min_rolls[square];
+
+    for (int roll = 1; roll <= DICE_SIDES && *found < limit; roll++) {
+        int next;
+        if (!optimal_roll(board, table, square, roll, rolls_left, &next)) continue;
+
+        rolls[depth] = roll;
+        if (next >= board->squares) {
+            function(context, rolls, depth + 1);
+            (*found)++;
+        } else {
+            list_from(board, table, next, rolls, depth + 1, limit, found, function, context);
+        }
+    }
+}
+
+// Call function with each optimal roll sequence from a square, smallest
+// rolls first, stopping after limit; returns the number listed
+long reach_list_sequences(const Board* board, const ReachTable* table, int start, long limit,
+                          RollSequenceFunction function, void* context) {
+    long found = 0;
+
+    if (start >= board->squares || table->min_rolls[start] <= 0) return 0;
+    int* rolls = malloc(sizeof(int) * table->min_rolls[start]);
+    if (rolls == NULL) {
+        printf("Out of memory in reachability search!\n");
+        return 0;
+    }
+    list_from(board, table, start, rolls, 0, limit, &found, function, context);
+    free(rolls);
+    return found;
+}
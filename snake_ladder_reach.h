@@ -0,0 +1,46 @@
+/*SNAKE & LADDER GAME - BITBOARD REACHABILITY*/
+#ifndef SNAKE_LADDER_REACH_H
+#define SNAKE_LADDER_REACH_H
+
+#include "snake_ladder_core.h"
+
+// Boards whose squares and overshoots fit one 128-bit set take the
+// single-register path; larger boards use arrays of 64-bit words
+#define REACH_WIDE_BITS 128
+
+// A board prepared for searching: bitset masks and the jump list, plus
+// scratch sets, so one board must not be searched from two threads at once
+typedef struct {
+    int squares;
+    int words;
+    int jumps;
+    int32_t* from;
+    int32_t* to;
+    uint64_t* starts;       // squares with a snake or ladder
+    uint64_t* finish;       // squares at or past the end
+    uint64_t* standing;     // squares a piece can stop on: no jump starts
+                            // there, or a jump ends there
+    uint64_t* scratch[3];
+} ReachBoard;
+
+// Fewest rolls needed to finish from every square a piece can stand on
+typedef struct {
+    int squares;
+    int max_rolls;          // largest finite entry
+    int* min_rolls;         // [square] = fewest rolls to finish, -1 if it never can or
+                            // no piece ever stops there
+} ReachTable;
+
+// Called with each optimal roll sequence found
+typedef void (*RollSequenceFunction)(void* context, const int* rolls, int count);
+
+int reach_board_init(ReachBoard* masks, const Board* board);
+void reach_board_free(ReachBoard* masks);
+int reach_min_rolls(ReachBoard* masks, int start);
+int reach_solve(ReachBoard* masks, ReachTable* table);
+void reach_free(ReachTable* table);
+long reach_count_sequences(const Board* board, const ReachTable* table, int start);
+long reach_list_sequences(const Board* board, const ReachTable* table, int start, long limit,
+                          RollSequenceFunction function, void* context);
+
+#endif
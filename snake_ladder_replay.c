@@ -0,0 +1,245 @@
+/*SNAKE & LADDER GAME - BINARY GAME REPLAYS*/
+// Games are stored as their dice rolls, 3 bits each, so a typical game takes
+// a few dozen bytes. Keyframes hold every player's position at regular turn
+// intervals: reconstructing any turn starts from the nearest keyframe before
+// it and replays at most keyframe_interval - 1 rolls.
+#include <stdlib.h>
+#include <string.h>
+#include "snake_ladder_replay.h"
+
+// Little-endian stores and loads, so files move between hosts of either
+// byte order; on little-endian hosts they compile to plain moves
+static void put_le(uint8_t* bytes, uint64_t value, int size) {
+    for (int i = 0; i < size; i++) bytes[i] = (uint8_t)(value >> (8 * i));
+}
+
+static uint64_t get_le(const uint8_t* bytes, int size) {
+    uint64_t value = 0;
+    for (int i = 0; i < size; i++) value |= (uint64_t)bytes[i] << (8 * i);
+    return value;
+}
+
+// Encode a header into its on-disk layout
+static void encode_header(const ReplayHeader* header, uint8_t* bytes) {
+    put_le(bytes, header->magic, 4);
+    put_le(bytes + 4, header->version, 2);
+    bytes[6] = header->num_players;
+    bytes[7] = header->winner;
+    put_le(bytes + 8, header->num_turns, 4);
+    put_le(bytes + 12, header->keyframe_interval, 2);
+    put_le(bytes + 14, header->reserved, 2);
+    put_le(bytes + 16, header->board_hash, 8);
+    put_le(bytes + 24, header->seed, 8);
+}
+
+// Decode a header from its on-disk layout
+static void decode_header(const uint8_t* bytes, ReplayHeader* header) {
+    header->magic = (uint32_t)get_le(bytes, 4);
+    header->version = (uint16_t)get_le(bytes + 4, 2);
+    header->num_players = bytes[6];
+    header->winner = bytes[7];
+    header->num_turns = (uint32_t)get_le(bytes + 8, 4);
+    header->keyframe_interval = (uint16_t)get_le(bytes + 12, 2);
+    header->reserved = (uint16_t)get_le(bytes + 14, 2);
+    header->board_hash = get_le(bytes + 16, 8);
+    header->seed = get_le(bytes + 24, 8);
+}
+
+// Keyframes stored in a record: one before each turn K, 2K, ... actually played
+static size_t keyframe_count(const ReplayHeader* header) {
+    return header->num_turns > 0 ? (header->num_turns - 1) / header->keyframe_interval : 0;
+}
+
+// Bytes of packed rolls in a record
+static size_t roll_bytes(uint32_t num_turns) {
+    return ((size_t)num_turns * REPLAY_ROLL_BITS + 7) / 8;
+}
+
+// Start recording a new game
+int replay_recorder_init(ReplayRecorder* recorder, const Board* board, int num_players, uint64_t seed) {
+    memset(recorder, 0, sizeof(*recorder));
+    if (num_players < 1 || num_players > MAX_PLAYERS) {
+        printf("Number of players must be between 1 and %d!\n", MAX_PLAYERS);
+        return 0;
+    }
+
+    recorder->header.magic = REPLAY_MAGIC;
+    recorder->header.version = REPLAY_VERSION;
+    recorder->header.num_players = (uint8_t)num_players;
+    recorder->header.winner = REPLAY_NO_WINNER;
+    recorder->header.keyframe_interval = REPLAY_KEYFRAME_INTERVAL;
+    recorder->header.board_hash = board_hash(board);
+    recorder->header.seed = seed;
+    recorder->board = board;
+    game_init(&recorder->game, num_players);
+    return 1;
+}
+
+// Release a recorder's buffers
+void replay_recorder_free(ReplayRecorder* recorder) {
+    free(recorder->rolls);
+    free(recorder->keyframes);
+    recorder->rolls = NULL;
+    recorder->keyframes = NULL;
+    recorder->roll_capacity = recorder->keyframe_capacity = 0;
+}
+
+// Make room for a keyframe and for the roll of the next turn
+static int reserve_turn(ReplayRecorder* recorder, int keyframe) {
+    size_t rolls_needed = roll_bytes(recorder->header.num_turns + 1);
+    if (rolls_needed > recorder->roll_capacity) {
+        size_t capacity = recorder->roll_capacity ? recorder->roll_capacity * 2 : 64;
+        uint8_t* rolls = realloc(recorder->rolls, capacity);
+        if (rolls == NULL) return 0;
+        memset(rolls + recorder->roll_capacity, 0, capacity - recorder->roll_capacity);
+        recorder->rolls = rolls;
+        recorder->roll_capacity = capacity;
+    }
+
+    size_t keyframes_needed = (keyframe_count(&recorder->header) + keyframe) * recorder->game.num_players;
+    if (keyframes_needed > recorder->keyframe_capacity) {
+        size_t capacity = recorder->keyframe_capacity ? recorder->keyframe_capacity * 2 : keyframes_needed;
+        int32_t* keyframes = realloc(recorder->keyframes, sizeof(int32_t) * capacity);
+        if (keyframes == NULL) return 0;
+        recorder->keyframes = keyframes;
+        recorder->keyframe_capacity = capacity;
+    }
+    return 1;
+}
+
+// Play one turn of the recorded game and append its roll
+int replay_record_turn(ReplayRecorder* recorder, int roll, TurnResult* result) {
+    ReplayHeader* header = &recorder->header;
+    Game* game = &recorder->game;
+    uint32_t turn = header->num_turns;
+    int keyframe = turn > 0 && turn % header->keyframe_interval == 0;
+
+    if (game->winner >= 0) {
+        printf("The recorded game is already over!\n");
+        return 0;
+    }
+    if (!reserve_turn(recorder, keyframe)) {
+        printf("Out of memory while recording a game!\n");
+        return 0;
+    }
+
+    if (keyframe) {
+        memcpy(recorder->keyframes + keyframe_count(header) * game->num_players, game->position,
+               sizeof(int32_t) * game->num_players);
+    }
+
+    game_take_turn(game, recorder->board, roll, result);
+
+    unsigned code = result->valid ? (unsigned)roll : REPLAY_LOST_TURN;
+    size_t bit = (size_t)turn * REPLAY_ROLL_BITS;
+    recorder->rolls[bit / 8] |= (uint8_t)(code << (bit % 8));
+    if (bit % 8 > 8 - REPLAY_ROLL_BITS) {
+        recorder->rolls[bit / 8 + 1] |= (uint8_t)(code >> (8 - bit % 8));
+    }
+
+    header->num_turns++;
+    if (game->winner >= 0) header->winner = (uint8_t)game->winner;
+    return 1;
+}
+
+// Append the recorded game to a replay file
+int replay_recorder_write(const ReplayRecorder* recorder, FILE* file) {
+    static const uint8_t padding[REPLAY_ALIGNMENT] = {0};
+    const ReplayHeader* header = &recorder->header;
+    size_t keyframe_bytes = sizeof(int32_t) * keyframe_count(header) * header->num_players;
+    size_t rolls = roll_bytes(header->num_turns);
+    size_t pad = replay_record_size(header) - REPLAY_HEADER_BYTES - keyframe_bytes - rolls;
+    uint8_t bytes[REPLAY_HEADER_BYTES];
+    int ok;
+
+    encode_header(header, bytes);
+    ok = fwrite(bytes, sizeof(bytes), 1, file) == 1;
+    for (size_t i = 0; ok && i < keyframe_bytes / sizeof(int32_t); i++) {
+        put_le(bytes, (uint32_t)recorder->keyframes[i], 4);
+        ok = fwrite(bytes, sizeof(int32_t), 1, file) == 1;
+    }
+    if (ok && rolls) ok = fwrite(recorder->rolls, rolls, 1, file) == 1;
+    if (ok && pad) ok = fwrite(padding, pad, 1, file) == 1;
+    if (!ok) printf("Could not write the replay!\n");
+    return ok;
+}
+
+// Size of the record a header starts, padding included
+size_t replay_record_size(const ReplayHeader* header) {
+    size_t size = REPLAY_HEADER_BYTES + sizeof(int32_t) * keyframe_count(header) * header->num_players +
+                  roll_bytes(header->num_turns);
+    return (size + REPLAY_ALIGNMENT - 1) / REPLAY_ALIGNMENT * REPLAY_ALIGNMENT;
+}
+
+// Parse the record at the start of a buffer; returns its size, or 0 if the
+// buffer does not start with a complete, valid record
+size_t replay_parse(const void* data, size_t size, ReplayRecord* record) {
+    if (size < REPLAY_HEADER_BYTES) return 0;
+    decode_header(data, &record->header);
+
+    const ReplayHeader* header = &record->header;
+    if (header->magic != REPLAY_MAGIC || header->version != REPLAY_VERSION ||
+        header->num_players < 1 || header->num_players > MAX_PLAYERS ||
+        header->keyframe_interval == 0) {
+        return 0;
+    }
+
+    record->size = replay_record_size(header);
+    if (record->size > size) return 0;
+
+    record->keyframes = (const uint8_t*)data + REPLAY_HEADER_BYTES;
+    record->rolls = record->keyframes + sizeof(int32_t) * keyframe_count(header) * header->num_players;
+    return record->size;
+}
+
+// Roll of one turn of a record (REPLAY_LOST_TURN for a lost turn)
+int replay_roll(const ReplayRecord* record, uint32_t turn) {
+    size_t bit = (size_t)turn * REPLAY_ROLL_BITS;
+    size_t byte = bit / 8;
+    unsigned bits = record->rolls[byte];
+    if (byte + 1 < roll_bytes(record->header.num_turns)) bits |= (unsigned)record->rolls[byte + 1] << 8;
+    return (int)((bits >> (bit % 8)) & ((1u << REPLAY_ROLL_BITS) - 1));
+}
+
+// Rebuild the state of a recorded game just before the given turn (the
+// final state when turn is the number of turns played); hash is the board's
+// hash. Keyframes come from the file, so positions off the board are
+// rejected rather than used as jump table indices.
+int replay_seek(const ReplayRecord* record, const Board* board, uint64_t hash, uint32_t turn, Game* game) {
+    const ReplayHeader* header = &record->header;
+    TurnResult result;
+
+    if (header->board_hash != hash) {
+        printf("The replay was recorded on a different board!\n");
+        return 0;
+    }
+    if (turn > header->num_turns) {
+        printf("The replay only has %u turns!\n", (unsigned)header->num_turns);
+        return 0;
+    }
+
+    // Start from the last keyframe at or before the turn
+    size_t keyframe = turn / header->keyframe_interval;
+    if (keyframe > keyframe_count(header)) keyframe = keyframe_count(header);
+
+    game_init(game, header->num_players);
+    if (keyframe > 0) {
+        const uint8_t* positions = record->keyframes + sizeof(int32_t) * (keyframe - 1) * header->num_players;
+        for (int player = 0; player < header->num_players; player++) {
+            int32_t position = (int32_t)get_le(positions + sizeof(int32_t) * player, 4);
+            if (position < 0 || position >= board->squares) {
+                printf("Corrupt replay keyframe: square %d!\n", (int)position);
+                return 0;
+            }
+            game->position[player] = position;
+        }
+        game->turns = (int)(keyframe * header->keyframe_interval);
+        game->current = game->turns % header->num_players;
+    }
+
+    // Turns recorded past a win would move a piece beyond the board
+    while ((uint32_t)game->turns < turn && game->winner < 0) {
+        game_take_turn(game, board, replay_roll(record, (uint32_t)game->turns), &result);
+    }
+    return 1;
+}
@@ -0,0 +1,73 @@
+/*SNAKE & LADDER GAME - BINARY GAME REPLAYS*/
+#ifndef SNAKE_LADDER_REPLAY_H
+#define SNAKE_LADDER_REPLAY_H
+
+#include <stdio.h>
+#include <stddef.h>
+#include "snake_ladder_core.h"
+
+// A replay file is a sequence of records, one per game, each laid out as
+//   ReplayHeader                  32 bytes
+//   keyframes                     int32 positions of every player before
+//                                 turns K, 2K, ... (K = keyframe_interval)
+//   rolls                         3 bits per turn, least significant first;
+//                                 0 marks a turn lost to an invalid roll
+//   padding                       to a multiple of 8 bytes
+// All fields are little-endian and the header fields are packed in the
+// order of ReplayHeader; records are encoded and decoded field by field, so
+// a file reads the same on a host of either byte order.
+#define REPLAY_HEADER_BYTES 32
+#define REPLAY_MAGIC 0x50524C53u    // "SLRP"
+#define REPLAY_VERSION 1
+#define REPLAY_KEYFRAME_INTERVAL 64
+#define REPLAY_ROLL_BITS 3
+#define REPLAY_LOST_TURN 0
+#define REPLAY_NO_WINNER 0xFF
+#define REPLAY_ALIGNMENT 8
+
+// Header at the start of every record
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint8_t num_players;
+    uint8_t winner;                 // REPLAY_NO_WINNER if the game was not finished
+    uint32_t num_turns;
+    uint16_t keyframe_interval;
+    uint16_t reserved;
+    uint64_t board_hash;
+    uint64_t seed;                  // dice seed the game was played with
+} ReplayHeader;
+
+// A game being recorded: it is played through the recorder so the rolls
+// and keyframes always match the game's rules
+typedef struct {
+    ReplayHeader header;
+    const Board* board;
+    Game game;
+    uint8_t* rolls;
+    size_t roll_capacity;           // bytes
+    int32_t* keyframes;
+    size_t keyframe_capacity;       // int32 entries
+} ReplayRecorder;
+
+// A record parsed in place from a buffer (for example a mapped file)
+typedef struct {
+    ReplayHeader header;
+    const uint8_t* keyframes;
+    const uint8_t* rolls;
+    size_t size;                    // bytes of the whole record
+} ReplayRecord;
+
+// Recording
+int replay_recorder_init(ReplayRecorder* recorder, const Board* board, int num_players, uint64_t seed);
+void replay_recorder_free(ReplayRecorder* recorder);
+int replay_record_turn(ReplayRecorder* recorder, int roll, TurnResult* result);
+int replay_recorder_write(const ReplayRecorder* recorder, FILE* file);
+
+// Replaying
+size_t replay_record_size(const ReplayHeader* header);
+size_t replay_parse(const void* data, size_t size, ReplayRecord* record);
+int replay_roll(const ReplayRecord* record, uint32_t turn);
+int replay_seek(const ReplayRecord* record, const Board* board, uint64_t hash, uint32_t turn, Game* game);
+
+#endif
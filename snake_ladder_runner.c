@@ -0,0 +1,175 @@
+/*SNAKE & LADDER GAME - MULTITHREADED MONTE CARLO RUNNER*/
+// Work is split into numbered chunks. Each worker starts with an equal,
+// contiguous share and takes chunks from the front of it; a worker that runs
+// dry steals the back half of another worker's share. A share is packed into
+// one 64-bit word (front << 32 | back) so both sides update it with a single
+// compare-and-swap.
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <unistd.h>
+#include "snake_ladder_runner.h"
+
+#define MAX_CHUNKS 0xFFFFFFFFL
+
+// One worker's remaining range of chunks, padded to its own cache line
+typedef struct {
+    _Atomic uint64_t range;
+    char padding[64 - sizeof(uint64_t)];
+} WorkQueue;
+
+// Shared state of one parallel run
+typedef struct {
+    WorkQueue* queues;
+    int threads;
+    ChunkFunction function;
+    void* context;
+} WorkPool;
+
+// Arguments of one worker thread
+typedef struct {
+    WorkPool* pool;
+    int worker;
+} WorkerArgs;
+
+static uint64_t pack_range(uint64_t front, uint64_t back) {
+    return front << 32 | back;
+}
+
+// Take the next chunk from the front of our own range
+static long pop_front(WorkQueue* queue) {
+    uint64_t range = atomic_load(&queue->range);
+    while (1) {
+        uint64_t front = range >> 32, back = range & 0xFFFFFFFFu;
+        if (front >= back) return -1;
+        if (atomic_compare_exchange_weak(&queue->range, &range, pack_range(front + 1, back))) {
+            return (long)front;
+        }
+    }
+}
+
+// Move the back half of a victim's range into our (empty) queue
+static int steal_half(WorkQueue* victim, WorkQueue* own) {
+    uint64_t range = atomic_load(&victim->range);
+    while (1) {
+        uint64_t front = range >> 32, back = range & 0xFFFFFFFFu;
+        if (front >= back) return 0;
+
+        uint64_t split = back - (back - front + 1) / 2;
+        if (atomic_compare_exchange_weak(&victim->range, &range, pack_range(front, split))) {
+            atomic_store(&own->range, pack_range(split, back));
+            return 1;
+        }
+    }
+}
+
+// Worker loop: drain our own range, then steal until nothing is left anywhere
+static void* worker_main(void* data) {
+    WorkerArgs* args = data;
+    WorkPool* pool = args->pool;
+    WorkQueue* own = &pool->queues[args->worker];
+
+    while (1) {
+        long chunk;
+        while ((chunk = pop_front(own)) >= 0) {
+            pool->function(pool->context, args->worker, chunk);
+        }
+
+        int stolen = 0;
+        for (int i = 1; i < pool->threads && !stolen; i++) {
+            stolen = steal_half(&pool->queues[(args->worker + i) % pool->threads], own);
+        }
+        if (!stolen) return NULL;
+    }
+}
+
+// Number of online CPU cores
+int runner_default_threads() {
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    if (cores < 1) return 1;
+    return cores < RUNNER_MAX_THREADS ? (int)cores : RUNNER_MAX_THREADS;
+}
+
+// Run function(context, worker, chunk) for every chunk across worker threads
+int run_parallel_chunks(long chunks, int threads, ChunkFunction function, void* context) {
+    if (chunks < 0 || chunks > MAX_CHUNKS) {
+        printf("Too many work chunks: %ld\n", chunks);
+        return 0;
+    }
+    if (threads < 1) threads = 1;
+    if (threads > RUNNER_MAX_THREADS) threads = RUNNER_MAX_THREADS;
+
+    WorkQueue* queues = aligned_alloc(64, sizeof(WorkQueue) * threads);
+    pthread_t handles[RUNNER_MAX_THREADS];
+    WorkerArgs args[RUNNER_MAX_THREADS];
+    WorkPool pool = {queues, threads, function, context};
+
+    if (queues == NULL) {
+        printf("Out of memory in parallel runner!\n");
+        return 0;
+    }
+
+    for (int i = 0; i < threads; i++) {
+        uint64_t front = (uint64_t)chunks * i / threads;
+        uint64_t back = (uint64_t)chunks * (i + 1) / threads;
+        atomic_init(&queues[i].range, pack_range(front, back));
+        args[i] = (WorkerArgs){&pool, i};
+    }
+
+    // The calling thread works as worker 0. A worker that fails to start
+    // leaves its share to be stolen by the others.
+    int started = 1;
+    for (int i = 1; i < threads; i++, started++) {
+        if (pthread_create(&handles[i], NULL, worker_main, &args[i]) != 0) break;
+    }
+    worker_main(&args[0]);
+    for (int i = 1; i < started; i++) {
+        pthread_join(handles[i], NULL);
+    }
+
+    free(queues);
+    return 1;
+}
+
+// Per-run state of a parallel simulation
+typedef struct {
+    const SimConfig* config;
+    long games;
+    GameRangeFunction simulate_range;
+    SimStats* worker_stats;
+} SimulationJob;
+
+// Simulate one chunk of games into the worker's own statistics
+static void simulate_chunk(void* context, int worker, long chunk) {
+    SimulationJob* job = context;
+    long first = chunk * RUNNER_CHUNK_GAMES;
+    long count = job->games - first < RUNNER_CHUNK_GAMES ? job->games - first : RUNNER_CHUNK_GAMES;
+
+    job->simulate_range(job->config, first, count, &job->worker_stats[worker]);
+}
+
+// Simulate a batch of games on all threads. Games draw dice from streams
+// derived from the seed and the game index and every statistic is an integer
+// sum, so the merged result is identical for any thread count.
+int run_parallel_simulation(const SimConfig* config, long games, int threads,
+                            GameRangeFunction simulate_range, SimStats* stats) {
+    if (threads < 1) threads = 1;
+    if (threads > RUNNER_MAX_THREADS) threads = RUNNER_MAX_THREADS;
+
+    SimulationJob job = {config, games, simulate_range, calloc(threads, sizeof(SimStats))};
+    if (job.worker_stats == NULL) {
+        printf("Out of memory in parallel runner!\n");
+        return 0;
+    }
+
+    long chunks = (games + RUNNER_CHUNK_GAMES - 1) / RUNNER_CHUNK_GAMES;
+    int ok = run_parallel_chunks(chunks, threads, simulate_chunk, &job);
+
+    for (int i = 0; ok && i < threads; i++) {
+        sim_stats_merge(stats, &job.worker_stats[i]);
+    }
+
+    free(job.worker_stats);
+    return ok;
+}
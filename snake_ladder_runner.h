@@ -0,0 +1,24 @@
+/*SNAKE & LADDER GAME - MULTITHREADED MONTE CARLO RUNNER*/
+#ifndef SNAKE_LADDER_RUNNER_H
+#define SNAKE_LADDER_RUNNER_H
+
+#include "snake_ladder_core.h"
+
+// Games per unit of work handed between threads
+#define RUNNER_CHUNK_GAMES 16384
+
+// Upper bound on worker threads
+#define RUNNER_MAX_THREADS 256
+
+// Work item run by a worker thread; chunks are numbered 0 .. chunks - 1
+typedef void (*ChunkFunction)(void* context, int worker, long chunk);
+
+// Plays games first .. first + count - 1 of a seeded batch into stats
+typedef void (*GameRangeFunction)(const SimConfig* config, long first, long count, SimStats* stats);
+
+int runner_default_threads();
+int run_parallel_chunks(long chunks, int threads, ChunkFunction function, void* context);
+int run_parallel_simulation(const SimConfig* config, long games, int threads,
+                            GameRangeFunction simulate_range, SimStats* stats);
+
+#endif
@@ -0,0 +1,465 @@
+/*SNAKE & LADDER GAME - MULTI-SESSION GAME SERVER*/
+// Build: cc -O2 -o snake_ladder_server snake_ladder_server.c snake_ladder_core.c
+// Usage: ./snake_ladder_server [--tcp port | --unix path] [--board file] [--players N] [--max-sessions N] [--seed S]
+//
+// Hosts one game per connection from a single epoll loop. Every session is a
+// fixed-size struct taken from a pool allocated at start-up, so memory stays
+// flat however many games are running. Each game is a TurnFlow coroutine,
+// the same one play_game() drives, suspended while it waits for a roll.
+//
+// The protocol is one line per command and per reply:
+//   <number>        play a turn with that roll; a roll outside 1-6 loses the turn
+//   ROLL            play a turn with a roll from the server's dice
+//   NEW [players]   start a new game
+//   STATE           show the current game
+//   QUIT            close the connection
+// Replies:
+//   HELLO <players> <squares>                      on connect
+//   TURN <player> <roll> <landed> <square> <none|snake|ladder>
+//   LOST <player> <roll>                           roll outside 1-6
+//   WIN <player> <turns>                           after the winning turn
+//   NEW <players>
+//   STATE <turns> <next player> <square> ...
+//   ERR <message>
+// Players are numbered from 1.
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#include <errno.h>
+#include <signal.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/resource.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include "snake_ladder_core.h"
+
+// Server limits
+#define SERVER_DEFAULT_PORT 7777
+#define SERVER_DEFAULT_SESSIONS 65536
+#define SERVER_BACKLOG 4096
+#define SERVER_MAX_EVENTS 256
+#define SERVER_LINE_MAX 64
+#define SERVER_OUTPUT_MAX 512
+#define SERVER_REPLY_MAX 128        // longest reply to one command
+#define SERVER_STATE_PLAYERS 8      // players listed by STATE
+
+// One connected client and its game
+typedef struct Session {
+    int fd;
+    int closing;                    // close once the output is flushed
+    uint32_t events;                // epoll events currently requested
+    int in_length;
+    int out_length;
+    DiceSource dice;
+    TurnFlow flow;
+    struct Session* next_free;
+    char in[SERVER_LINE_MAX];
+    char out[SERVER_OUTPUT_MAX];
+} Session;
+
+// Global variables
+Board board;
+int default_players = DEFAULT_PLAYERS;
+uint64_t server_seed = 1;
+int epoll_fd = -1;
+int listen_fd = -1;
+Session* sessions = NULL;
+Session* free_sessions = NULL;
+long sessions_served = 0;
+long sessions_rejected = 0;
+long games_finished = 0;
+long turns_played = 0;
+volatile sig_atomic_t stop_requested = 0;
+
+// Stop the event loop on SIGINT or SIGTERM
+static void request_stop(int signal_number) {
+    (void)signal_number;
+    stop_requested = 1;
+}
+
+// Raise the open-file limit as far as allowed; returns the limit
+static long raise_file_limit() {
+    struct rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) != 0) return 1024;
+    limit.rlim_cur = limit.rlim_max;
+    setrlimit(RLIMIT_NOFILE, &limit);
+    getrlimit(RLIMIT_NOFILE, &limit);
+    return (long)limit.rlim_cur;
+}
+
+// Create the pool every session is taken from
+static int create_session_pool(int max_sessions) {
+    sessions = calloc(max_sessions, sizeof(Session));
+    if (sessions == NULL) {
+        printf("Out of memory for %d sessions!\n", max_sessions);
+        return 0;
+    }
+    for (int i = max_sessions - 1; i >= 0; i--) {
+        sessions[i].fd = -1;
+        sessions[i].next_free = free_sessions;
+        free_sessions = &sessions[i];
+    }
+    return 1;
+}
+
+// Append one formatted reply to a session's output
+static void reply(Session* session, const char* format, ...) __attribute__((format(printf, 2, 3)));
+static void reply(Session* session, const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+    int room = SERVER_OUTPUT_MAX - session->out_length;
+    int length = vsnprintf(session->out + session->out_length, room, format, args);
+    va_end(args);
+    if (length > 0) session->out_length += length < room ? length : room - 1;
+}
+
+// Start a new game in a session and run it up to its first roll
+static void start_game(Session* session, int num_players) {
+    turn_flow_init(&session->flow, num_players);
+    turn_flow_resume(&session->flow, &board, 0);
+}
+
+// Resume a session's game with a roll and report what happens until it
+// needs the next one
+static void play_turn(Session* session, int roll) {
+    static const char* jump_names[] = {"none", "snake", "ladder"};
+    TurnFlow* flow = &session->flow;
+    const TurnResult* turn = &flow->turn;
+
+    if (flow->event == TURN_GAME_OVER) {
+        reply(session, "ERR game over, send NEW\n");
+        return;
+    }
+
+    TurnEvent event = turn_flow_resume(flow, &board, roll);
+    turns_played++;
+    while (event != TURN_NEED_ROLL) {
+        if (event == TURN_LOST) {
+            reply(session, "LOST %d %d\n", turn->player + 1, turn->roll);
+        } else if (event == TURN_MOVED) {
+            reply(session, "TURN %d %d %d %d %s\n", turn->player + 1, turn->roll, turn->landed,
+                  turn->position, jump_names[turn->jump]);
+        } else if (event == TURN_GAME_OVER) {
+            reply(session, "WIN %d %d\n", flow->game.winner + 1, flow->game.turns);
+            games_finished++;
+            return;
+        }
+        event = turn_flow_resume(flow, &board, 0);
+    }
+}
+
+// Report the state of a session's game
+static void report_state(Session* session) {
+    const Game* game = &session->flow.game;
+    int shown = game->num_players < SERVER_STATE_PLAYERS ? game->num_players : SERVER_STATE_PLAYERS;
+
+    reply(session, "STATE %d %d", game->turns, game->current + 1);
+    for (int p = 0; p < shown; p++) reply(session, " %d", game->position[p]);
+    reply(session, "\n");
+}
+
+// Carry out one command line
+static void handle_command(Session* session, char* line) {
+    char* end;
+    long roll = strtol(line, &end, 10);
+
+    if (end != line && *end == '\0') {
+        play_turn(session, roll < -999 || roll > 999 ? 0 : (int)roll);
+    } else if (strcmp(line, "ROLL") == 0) {
+        play_turn(session, dice_roll(&session->dice));
+    } else if (strncmp(line, "NEW", 3) == 0 && (line[3] == '\0' || line[3] == ' ')) {
+        int players = line[3] ? atoi(line + 4) : default_players;
+        if (players < 1 || players > MAX_PLAYERS) {
+            reply(session, "ERR players must be between 1 and %d\n", MAX_PLAYERS);
+        } else {
+            start_game(session, players);
+            reply(session, "NEW %d\n", players);
+        }
+    } else if (strcmp(line, "STATE") == 0) {
+        report_state(session);
+    } else if (strcmp(line, "QUIT") == 0) {
+        session->closing = 1;
+    } else {
+        reply(session, "ERR unknown command\n");
+    }
+}
+
+// Run every complete line in the input buffer while there is room to answer
+static void process_input(Session* session) {
+    int start = 0;
+
+    while (!session->closing && SERVER_OUTPUT_MAX - session->out_length >= SERVER_REPLY_MAX) {
+        char* newline = memchr(session->in + start, '\n', session->in_length - start);
+        if (newline == NULL) break;
+
+        *newline = '\0';
+        if (newline > session->in + start && newline[-1] == '\r') newline[-1] = '\0';
+        handle_command(session, session->in + start);
+        start = (int)(newline - session->in) + 1;
+    }
+
+    session->in_length -= start;
+    memmove(session->in, session->in + start, session->in_length);
+}
+
+// Write as much pending output as the socket takes; returns 0 on error
+static int flush_output(Session* session) {
+    int sent = 0;
+    while (sent < session->out_length) {
+        ssize_t n = send(session->fd, session->out + sent, session->out_length - sent, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+            return 0;
+        }
+        sent += (int)n;
+    }
+    session->out_length -= sent;
+    memmove(session->out, session->out + sent, session->out_length);
+    return 1;
+}
+
+// Ask for input only while replies fit and for writability only while
+// output is pending, so a slow reader pauses its own session and no other
+static void update_interest(Session* session) {
+    uint32_t events = 0;
+    if (session->out_length > 0) events |= EPOLLOUT;
+    if (!session->closing && SERVER_OUTPUT_MAX - session->out_length >= SERVER_REPLY_MAX) events |= EPOLLIN;
+    if (events == session->events) return;
+
+    struct epoll_event event = {.events = events, .data.ptr = session};
+    epoll_ctl(epoll_fd, EPOLL_CTL_MOD, session->fd, &event);
+    session->events = events;
+}
+
+// Disconnect a session and return it to the pool
+static void close_session(Session* session) {
+    close(session->fd);
+    session->fd = -1;
+    session->next_free = free_sessions;
+    free_sessions = session;
+}
+
+// Take in every pending connection
+static void accept_clients() {
+    while (1) {
+        int fd = accept4(listen_fd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            if (errno == EINTR || errno == ECONNABORTED) continue;
+            if (errno != EAGAIN && errno != EWOULDBLOCK) perror("accept");
+            return;
+        }
+
+        Session* session = free_sessions;
+        if (session == NULL) {
+            sessions_rejected++;
+            close(fd);
+            continue;
+        }
+
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+        struct epoll_event event = {.events = EPOLLIN, .data.ptr = session};
+        if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &event) != 0) {
+            close(fd);
+            continue;
+        }
+
+        free_sessions = session->next_free;
+        session->fd = fd;
+        session->closing = 0;
+        session->events = EPOLLIN;
+        session->in_length = session->out_length = 0;
+        dice_seed(&session->dice, game_seed(server_seed, sessions_served++));
+        start_game(session, default_players);
+        reply(session, "HELLO %d %d\n", default_players, board.squares);
+        flush_output(session);
+        update_interest(session);
+    }
+}
+
+// Service one ready session
+static void handle_session(Session* session, uint32_t events) {
+    int ok = 1;
+
+    if (events & EPOLLIN) {
+        while (ok && session->in_length < SERVER_LINE_MAX) {
+            ssize_t n = recv(session->fd, session->in + session->in_length,
+                             SERVER_LINE_MAX - session->in_length, 0);
+            if (n > 0) {
+                session->in_length += (int)n;
+                process_input(session);
+                ok = flush_output(session);
+                if (SERVER_OUTPUT_MAX - session->out_length < SERVER_REPLY_MAX) break;
+            } else if (n == 0) {
+                ok = 0;
+            } else if (errno != EINTR) {
+                if (errno != EAGAIN && errno != EWOULDBLOCK) ok = 0;
+                break;
+            }
+        }
+        if (session->in_length == SERVER_LINE_MAX && !memchr(session->in, '\n', SERVER_LINE_MAX)) {
+            reply(session, "ERR line too long\n");
+            session->closing = 1;
+        }
+    } else if (events & (EPOLLERR | EPOLLHUP)) {
+        ok = 0;
+    }
+
+    if (ok && (events & EPOLLOUT)) {
+        ok = flush_output(session);
+        // Lines held back while the output was full
+        if (ok) process_input(session);
+        if (ok) ok = flush_output(session);
+    }
+
+    if (!ok || (session->closing && session->out_length == 0)) {
+        close_session(session);
+    } else {
+        update_interest(session);
+    }
+}
+
+// Open the listening socket
+static int open_listener(int port, const char* unix_path) {
+    int fd;
+
+    if (unix_path) {
+        struct sockaddr_un address = {.sun_family = AF_UNIX};
+        if (strlen(unix_path) >= sizeof(address.sun_path)) {
+            printf("Socket path %s is too long!\n", unix_path);
+            return -1;
+        }
+        strcpy(address.sun_path, unix_path);
+        unlink(unix_path);
+
+        fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (fd < 0 || bind(fd, (struct sockaddr*)&address, sizeof(address)) != 0) {
+            perror("bind");
+            if (fd >= 0) close(fd);
+            return -1;
+        }
+    } else {
+        struct sockaddr_in address = {.sin_family = AF_INET, .sin_port = htons((uint16_t)port),
+                                      .sin_addr.s_addr = htonl(INADDR_ANY)};
+        int one = 1;
+
+        fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (fd >= 0) setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+        if (fd < 0 || bind(fd, (struct sockaddr*)&address, sizeof(address)) != 0) {
+            perror("bind");
+            if (fd >= 0) close(fd);
+            return -1;
+        }
+    }
+
+    if (listen(fd, SERVER_BACKLOG) != 0) {
+        perror("listen");
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+// Main function
+int main(int argc, char** argv) {
+    const char* unix_path = NULL;
+    const char* board_path = NULL;
+    int port = SERVER_DEFAULT_PORT;
+    int max_sessions = SERVER_DEFAULT_SESSIONS;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--tcp") == 0 && i + 1 < argc) {
+            port = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--unix") == 0 && i + 1 < argc) {
+            unix_path = argv[++i];
+        } else if (strcmp(argv[i], "--board") == 0 && i + 1 < argc) {
+            board_path = argv[++i];
+        } else if (strcmp(argv[i], "--players") == 0 && i + 1 < argc) {
+            default_players = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--max-sessions") == 0 && i + 1 < argc) {
+            max_sessions = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            server_seed = strtoull(argv[++i], NULL, 0);
+        } else {
+            printf("Usage: %s [--tcp port | --unix path] [--board file] [--players N] "
+                   "[--max-sessions N] [--seed S]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (default_players < 1 || default_players > MAX_PLAYERS) {
+        printf("Number of players must be between 1 and %d!\n", MAX_PLAYERS);
+        return 1;
+    }
+    if (max_sessions < 1) {
+        printf("Number of sessions must be positive!\n");
+        return 1;
+    }
+
+    // Keep a few descriptors for the listener, epoll and stdio
+    long file_limit = raise_file_limit();
+    if (max_sessions > file_limit - 16) {
+        max_sessions = (int)(file_limit - 16);
+        printf("Open-file limit allows only %d sessions\n", max_sessions);
+    }
+
+    if (board_path ? !board_load(&board, board_path) : !board_init_classic(&board)) {
+        return 1;
+    }
+    if (!create_session_pool(max_sessions)) {
+        board_free(&board);
+        return 1;
+    }
+
+    listen_fd = open_listener(port, unix_path);
+    epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    struct epoll_event listen_event = {.events = EPOLLIN, .data.ptr = NULL};
+    if (listen_fd < 0 || epoll_fd < 0 || epoll_ctl(epoll_fd, EPOLL_CTL_ADD, listen_fd, &listen_event) != 0) {
+        printf("Could not start the server!\n");
+        return 1;
+    }
+
+    struct sigaction action = {.sa_handler = request_stop};
+    sigaction(SIGINT, &action, NULL);
+    sigaction(SIGTERM, &action, NULL);
+    signal(SIGPIPE, SIG_IGN);
+
+    if (unix_path) printf("Listening on %s, up to %d sessions\n", unix_path, max_sessions);
+    else printf("Listening on port %d, up to %d sessions\n", port, max_sessions);
+    fflush(stdout);
+
+    struct epoll_event events[SERVER_MAX_EVENTS];
+    while (!stop_requested) {
+        int count = epoll_wait(epoll_fd, events, SERVER_MAX_EVENTS, -1);
+        if (count < 0) {
+            if (errno == EINTR) continue;
+            perror("epoll_wait");
+            break;
+        }
+        for (int i = 0; i < count; i++) {
+            if (events[i].data.ptr == NULL) accept_clients();
+            else handle_session(events[i].data.ptr, events[i].events);
+        }
+    }
+
+    printf("Sessions served: %ld (%ld rejected)\n", sessions_served, sessions_rejected);
+    printf("Games finished:  %ld\n", games_finished);
+    printf("Turns played:    %ld\n", turns_played);
+
+    for (int i = 0; i < max_sessions; i++) {
+        if (sessions[i].fd >= 0) close(sessions[i].fd);
+    }
+    close(listen_fd);
+    close(epoll_fd);
+    if (unix_path) unlink(unix_path);
+    free(sessions);
+    board_free(&board);
+    return 0;
+}
@@ -0,0 +1,936 @@
+/*SNAKE & LADDER GAME - HEADLESS BATCH SIMULATOR*/
+// Build: cc -O2 -pthread -o snake_ladder_sim snake_ladder_sim.c snake_ladder_core.c snake_ladder_markov.c snake_ladder_runner.c snake_ladder_lockstep.c snake_ladder_replay.c snake_ladder_analytics.c snake_ladder_optimizer.c snake_ladder_reach.c snake_ladder_policy.c snake_ladder_ai.c snake_ladder_tournament.c -lm
+// Usage: ./snake_ladder_sim simulate [games] [seed] [board file] [--players N] [--threads N] [--kernel scalar|lockstep]
+//        ./snake_ladder_sim exact [board file] [--players N] [--dist]
+//        ./snake_ladder_sim record <replay file> [games] [seed] [board file] [--players N]
+//        ./snake_ladder_sim replay <replay file> [board file] [--game N] [--turn T]
+//        ./snake_ladder_sim analyze <replay file> [board file] [--threads N]
+//        ./snake_ladder_sim optimize <output board> [start board] --length L [--variance V] [--advantage A]
+//                                    [--snakes N --ladders N] [--iterations N] [--chains N] [--seed S]
+//                                    [--players N] [--threads N]
+//        ./snake_ladder_sim reach [board file] [--from S] [--sequences N]
+//        ./snake_ladder_sim policy [board file] [--cache FILE] [--from A B]
+//        ./snake_ladder_sim ai [board file] [--tokens N] [--exact] [--bonus] [--chosen]
+//                              [--games N] [--budget MS] [--seed S]
+//        ./snake_ladder_sim tournament [board file] [--strategies a,b,...] [--matches N] [--seed S]
+//                                      [--depth D] [--threads N]
+//        ./snake_ladder_sim dice [seed] [--rolls N]
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "snake_ladder_core.h"
+#include "snake_ladder_markov.h"
+#include "snake_ladder_runner.h"
+#include "snake_ladder_lockstep.h"
+#include "snake_ladder_replay.h"
+#include "snake_ladder_analytics.h"
+#include "snake_ladder_optimizer.h"
+#include "snake_ladder_reach.h"
+#include "snake_ladder_policy.h"
+#include "snake_ladder_ai.h"
+#include "snake_ladder_tournament.h"
+
+// Rolls of a dice stream checked against direct computation: the first
+// stretch, and a few stretches reached by jumping ahead
+#define DICE_CHECK_ROLLS 1000000
+#define DICE_CHECK_JUMPS 16
+
+// Wall clock in seconds
+static double now_seconds() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// Load the board named on the command line, or the original one
+static int load_board_arg(Board* board, const char* path) {
+    if (path == NULL) return board_init_classic(board);
+    return board_load(board, path);
+}
+
+// Parse a --players value, or the default when it was not given
+static int parse_players(const char* arg) {
+    int players = arg ? atoi(arg) : DEFAULT_PLAYERS;
+    if (players < 1 || players > MAX_PLAYERS) {
+        printf("Number of players must be between 1 and %d!\n", MAX_PLAYERS);
+        return 0;
+    }
+    return players;
+}
+
+// Print a summary of a batch run
+static void print_stats(const SimStats* stats, int num_players, double seconds) {
+    printf("Games played:   %ld\n", stats->games);
+    printf("Games/second:   %.0f\n", stats->games / seconds);
+    for (int p = 0; p < num_players; p++) {
+        printf("Player %2d wins: %ld (%.3f%%)\n", p + 1, stats->wins[p],
+               100.0 * stats->wins[p] / stats->games);
+    }
+    printf("Mean turns:     %.3f\n", (double)stats->total_turns / stats->games);
+}
+
+// Remove a "--name value" option from the argument list, returning its value
+static const char* take_option(int* argc, char** argv, const char* name) {
+    for (int i = 0; i + 1 < *argc; i++) {
+        if (strcmp(argv[i], name) == 0) {
+            const char* value = argv[i + 1];
+            for (int j = i; j + 2 < *argc; j++) argv[j] = argv[j + 2];
+            *argc -= 2;
+            return value;
+        }
+    }
+    return NULL;
+}
+
+// Monte Carlo simulation of many games
+static int run_simulate(int argc, char** argv) {
+    const char* threads_arg = take_option(&argc, argv, "--threads");
+    const char* kernel_arg = take_option(&argc, argv, "--kernel");
+    int players = parse_players(take_option(&argc, argv, "--players"));
+    int threads = threads_arg ? atoi(threads_arg) : runner_default_threads();
+    GameRangeFunction simulate_range = simulate_game_range;
+    const char* kernel_name = "scalar";
+    long games = argc > 0 ? atol(argv[0]) : 1000000;
+    uint64_t seed = argc > 1 ? strtoull(argv[1], NULL, 0) : 1;
+    Board board;
+
+    if (games <= 0) {
+        printf("Number of games must be positive!\n");
+        return 1;
+    }
+    if (players == 0) {
+        return 1;
+    }
+    if (threads < 1) {
+        printf("Number of threads must be positive!\n");
+        return 1;
+    }
+    if (kernel_arg && strcmp(kernel_arg, "lockstep") == 0) {
+        simulate_range = lockstep_simulate_range;
+        kernel_name = players == 2 ? lockstep_kernel_name() : "scalar";
+    } else if (kernel_arg && strcmp(kernel_arg, "scalar") != 0) {
+        printf("Unknown kernel %s!\n", kernel_arg);
+        return 1;
+    }
+    if (!load_board_arg(&board, argc > 2 ? argv[2] : NULL)) {
+        return 1;
+    }
+
+    SimConfig config = {&board, players, seed};
+    SimStats stats;
+    sim_stats_reset(&stats);
+
+    double start = now_seconds();
+    if (!run_parallel_simulation(&config, games, threads, simulate_range, &stats)) {
+        board_free(&board);
+        return 1;
+    }
+    print_stats(&stats, players, now_seconds() - start);
+    printf("Threads:        %d\n", threads);
+    printf("Kernel:         %s\n", kernel_name);
+
+    board_free(&board);
+    return 0;
+}
+
+// Exact analysis of the board's absorbing Markov chain
+static int run_exact(int argc, char** argv) {
+    int players = parse_players(take_option(&argc, argv, "--players"));
+    const char* path = NULL;
+    int show_dist = 0;
+    Board board;
+    MarkovResult result;
+
+    if (players == 0) {
+        return 1;
+    }
+    for (int i = 0; i < argc; i++) {
+        if (strcmp(argv[i], "--dist") == 0) show_dist = 1;
+        else path = argv[i];
+    }
+    if (!load_board_arg(&board, path)) {
+        return 1;
+    }
+
+    // Longer boards need more turns before the unfinished tail vanishes
+    int max_turns = MARKOV_TURNS_PER_SQUARE * board.squares;
+    if (max_turns < MARKOV_DEFAULT_MAX_TURNS) max_turns = MARKOV_DEFAULT_MAX_TURNS;
+
+    double start = now_seconds();
+    int ok = markov_analyze(&board, players, max_turns, &result);
+    board_free(&board);
+    if (!ok) {
+        return 1;
+    }
+    double elapsed = now_seconds() - start;
+
+    printf("Turns per player:   mean %.6f, variance %.6f\n",
+           result.player_expected_turns, result.player_turns_variance);
+    printf("Game length:        mean %.6f, variance %.6f\n",
+           result.game_expected_turns, result.game_turns_variance);
+    for (int p = 0; p < players; p++) {
+        printf("Player %2d wins:     %.9f\n", p + 1, result.win_probability[p]);
+    }
+    printf("Unresolved tail:    %.3g after %d turns\n", result.tail_mass, result.turns_tracked);
+    printf("Analysis time:      %.1f us\n", elapsed * 1e6);
+
+    if (show_dist) {
+        printf("\nturn  P(game ends)\n");
+        for (int t = 1; t <= result.turns_tracked * players; t++) {
+            if (result.game_length[t] > 0.0) printf("%4d  %.12f\n", t, result.game_length[t]);
+        }
+    }
+
+    markov_free(&result);
+    return 0;
+}
+
+// Play seeded games and append them to a replay file
+static int run_record(int argc, char** argv) {
+    int players = parse_players(take_option(&argc, argv, "--players"));
+    long games = argc > 1 ? atol(argv[1]) : 1000;
+    uint64_t seed = argc > 2 ? strtoull(argv[2], NULL, 0) : 1;
+    ReplayRecorder recorder;
+    TurnResult turn;
+    DiceSource dice;
+    Board board;
+    int ok = 1;
+
+    if (argc < 1) {
+        printf("No replay file given!\n");
+        return 1;
+    }
+    if (games <= 0) {
+        printf("Number of games must be positive!\n");
+        return 1;
+    }
+    if (players == 0 || !load_board_arg(&board, argc > 3 ? argv[3] : NULL)) {
+        return 1;
+    }
+
+    FILE* file = fopen(argv[0], "ab");
+    if (file == NULL) {
+        printf("Could not open %s!\n", argv[0]);
+        board_free(&board);
+        return 1;
+    }
+    long start_bytes = ftell(file);
+
+    double start = now_seconds();
+    for (long i = 0; i < games && ok; i++) {
+        dice_seed(&dice, game_seed(seed, i));
+        ok = replay_recorder_init(&recorder, &board, players, game_seed(seed, i));
+        while (ok && recorder.game.winner < 0) {
+            ok = replay_record_turn(&recorder, dice_roll(&dice), &turn);
+        }
+        if (ok) ok = replay_recorder_write(&recorder, file);
+        replay_recorder_free(&recorder);
+    }
+    double elapsed = now_seconds() - start;
+    long bytes = ftell(file) - start_bytes;
+
+    if (fclose(file) != 0) ok = 0;
+    board_free(&board);
+    if (!ok) return 1;
+
+    printf("Games recorded: %ld\n", games);
+    printf("Bytes written:  %ld (%.1f per game)\n", bytes, (double)bytes / games);
+    printf("Games/second:   %.0f\n", games / elapsed);
+    return 0;
+}
+
+// Read a whole replay file into memory
+static uint8_t* read_replay_file(const char* path, size_t* size) {
+    FILE* file = fopen(path, "rb");
+    if (file == NULL) {
+        printf("Could not open %s!\n", path);
+        return NULL;
+    }
+
+    fseek(file, 0, SEEK_END);
+    long length = ftell(file);
+    fseek(file, 0, SEEK_SET);
+
+    uint8_t* data = malloc(length > 0 ? (size_t)length : 1);
+    if (data == NULL || (length > 0 && fread(data, (size_t)length, 1, file) != 1)) {
+        printf("Could not read %s!\n", path);
+        free(data);
+        data = NULL;
+    }
+    fclose(file);
+    *size = length > 0 ? (size_t)length : 0;
+    return data;
+}
+
+// Print a recorded game's state just before one of its turns
+static void print_replay_state(const ReplayRecord* record, const Game* game) {
+    printf("Turn:           %d of %u\n", game->turns, (unsigned)record->header.num_turns);
+    printf("Seed:           0x%016llx\n", (unsigned long long)record->header.seed);
+    for (int p = 0; p < game->num_players; p++) {
+        printf("Player %2d:      square %d%s\n", p + 1, game->position[p],
+               game->winner == p ? " (winner)" : "");
+    }
+    if (game->winner < 0) printf("Next to move:   player %d\n", game->current + 1);
+}
+
+// Show one recorded game at a given turn, or check every game in a file
+static int run_replay(int argc, char** argv) {
+    const char* game_arg = take_option(&argc, argv, "--game");
+    const char* turn_arg = take_option(&argc, argv, "--turn");
+    long games = 0, mismatches = 0;
+    ReplayRecord record;
+    Board board;
+    Game game;
+    size_t size;
+    int ok = 1;
+
+    if (argc < 1) {
+        printf("No replay file given!\n");
+        return 1;
+    }
+    if (!load_board_arg(&board, argc > 1 ? argv[1] : NULL)) {
+        return 1;
+    }
+    uint8_t* data = read_replay_file(argv[0], &size);
+    if (data == NULL) {
+        board_free(&board);
+        return 1;
+    }
+
+    uint64_t hash = board_hash(&board);
+    double start = now_seconds();
+    for (size_t offset = 0; offset < size && ok; offset += record.size) {
+        if (!replay_parse(data + offset, size - offset, &record)) {
+            printf("Corrupt replay record at byte %zu!\n", offset);
+            ok = 0;
+        } else if (game_arg) {
+            if (games++ != atol(game_arg)) continue;
+            uint32_t turn = turn_arg ? (uint32_t)strtoul(turn_arg, NULL, 0) : record.header.num_turns;
+            ok = replay_seek(&record, &board, hash, turn, &game);
+            if (ok) print_replay_state(&record, &game);
+            break;
+        } else {
+            // Replay to the end and check the stored winner
+            ok = replay_seek(&record, &board, hash, record.header.num_turns, &game);
+            if (ok && (game.winner < 0 ? REPLAY_NO_WINNER : game.winner) != record.header.winner) {
+                mismatches++;
+            }
+            games++;
+        }
+    }
+    double elapsed = now_seconds() - start;
+
+    if (ok && game_arg && games <= atol(game_arg)) {
+        printf("The file has only %ld games!\n", games);
+        ok = 0;
+    }
+    if (ok && !game_arg) {
+        printf("Games replayed: %ld\n", games);
+        printf("Mismatches:     %ld\n", mismatches);
+        printf("Games/second:   %.0f\n", games / elapsed);
+        if (mismatches > 0) ok = 0;
+    }
+
+    free(data);
+    board_free(&board);
+    return ok ? 0 : 1;
+}
+
+// Turn count below which a fraction of the finished games ended
+static int length_percentile(const ReplayStats* stats, double fraction) {
+    long finished = stats->games - stats->unfinished;
+    long seen = 0;
+    for (int t = 0; t <= MAX_TRACKED_TURNS; t++) {
+        seen += stats->length_hist[t];
+        if (seen > 0 && seen >= fraction * finished) return t;
+    }
+    return MAX_TRACKED_TURNS;
+}
+
+// Print the aggregate statistics of a replay archive
+static void print_replay_stats(const ReplayStats* stats, const Board* board, double seconds) {
+    long finished = stats->games - stats->unfinished;
+
+    printf("Games analyzed: %ld (%ld on other boards skipped)\n", stats->games, stats->other_board);
+    printf("Throughput:     %.0f games/s, %.1f MB/s\n",
+           (stats->games + stats->other_board) / seconds, stats->bytes / seconds / 1e6);
+    if (stats->games == 0) return;
+
+    printf("Unfinished:     %ld\n", stats->unfinished);
+    printf("Lost turns:     %ld\n", stats->lost_turns);
+    printf("Game length:    mean %.3f, median %d, 90%% %d, 99%% %d turns\n",
+           (double)stats->total_turns / stats->games, length_percentile(stats, 0.5),
+           length_percentile(stats, 0.9), length_percentile(stats, 0.99));
+
+    // First-mover advantage: player 1's wins against an even share, both
+    // counted over finished games only
+    double fair_share = 0.0;
+    for (int n = 1; n <= MAX_PLAYERS; n++) fair_share += (double)stats->finished_by_players[n] / n;
+    if (finished > 0) {
+        printf("First mover:    %.3f%% of wins, %.3f%% expected without an advantage\n",
+               100.0 * stats->wins[0] / finished, 100.0 * fair_share / finished);
+    }
+    for (int p = 0; p < MAX_PLAYERS; p++) {
+        if (stats->wins[p] > 0) printf("Player %2d wins: %ld\n", p + 1, stats->wins[p]);
+    }
+
+    printf("\nsquare  kind    to      hits  per game\n");
+    for (int square = 1; square < board->squares; square++) {
+        long hits = board->kind[square] == JUMP_SNAKE ? stats->snake_hits[square] : stats->ladder_hits[square];
+        if (board->kind[square] == JUMP_NONE) continue;
+        printf("%6d  %-6s  %6d  %8ld  %.4f\n", square,
+               board->kind[square] == JUMP_SNAKE ? "snake" : "ladder", board_jump(board, square),
+               hits, (double)hits / stats->games);
+    }
+}
+
+// Aggregate statistics over a replay archive, scanned in place on all cores
+static int run_analyze(int argc, char** argv) {
+    const char* threads_arg = take_option(&argc, argv, "--threads");
+    int threads = threads_arg ? atoi(threads_arg) : runner_default_threads();
+    ReplayStats stats;
+    Board board;
+
+    if (argc < 1) {
+        printf("No replay file given!\n");
+        return 1;
+    }
+    if (threads < 1) {
+        printf("Number of threads must be positive!\n");
+        return 1;
+    }
+    if (!load_board_arg(&board, argc > 1 ? argv[1] : NULL)) {
+        return 1;
+    }
+    if (!replay_stats_init(&stats, &board)) {
+        board_free(&board);
+        return 1;
+    }
+
+    double start = now_seconds();
+    int ok = analyze_replay_file(argv[0], &board, threads, &stats);
+    if (ok) print_replay_stats(&stats, &board, now_seconds() - start);
+
+    replay_stats_free(&stats);
+    board_free(&board);
+    return ok ? 0 : 1;
+}
+
+// Print a board's exact metrics as scored by the optimizer
+static void print_board_score(const char* label, const BoardScore* score) {
+    printf("%-8s length %.3f, variance %.1f, first-player advantage %+.4f, score %.3g\n",
+           label, score->length, score->variance, score->advantage, score->score);
+}
+
+// Search snake and ladder layouts for one that meets target metrics
+static int run_optimize(int argc, char** argv) {
+    const char* length_arg = take_option(&argc, argv, "--length");
+    const char* variance_arg = take_option(&argc, argv, "--variance");
+    const char* advantage_arg = take_option(&argc, argv, "--advantage");
+    const char* snakes_arg = take_option(&argc, argv, "--snakes");
+    const char* ladders_arg = take_option(&argc, argv, "--ladders");
+    const char* iterations_arg = take_option(&argc, argv, "--iterations");
+    const char* chains_arg = take_option(&argc, argv, "--chains");
+    const char* seed_arg = take_option(&argc, argv, "--seed");
+    const char* threads_arg = take_option(&argc, argv, "--threads");
+    int players = parse_players(take_option(&argc, argv, "--players"));
+    int threads = threads_arg ? atoi(threads_arg) : runner_default_threads();
+    OptimizerConfig config = {
+        players,
+        snakes_arg ? atoi(snakes_arg) : 0,
+        ladders_arg ? atoi(ladders_arg) : 0,
+        length_arg ? atof(length_arg) : 0.0,
+        variance_arg ? atof(variance_arg) : 0.0,
+        advantage_arg ? atof(advantage_arg) : OPTIMIZER_DEFAULT_ADVANTAGE,
+        iterations_arg ? atol(iterations_arg) : OPTIMIZER_DEFAULT_ITERATIONS,
+        chains_arg ? atoi(chains_arg) : OPTIMIZER_DEFAULT_CHAINS,
+        seed_arg ? strtoull(seed_arg, NULL, 0) : 1
+    };
+    BoardScore start_score, best_score;
+    Board start, best;
+
+    if (argc < 1) {
+        printf("No output board file given!\n");
+        return 1;
+    }
+    if (players == 0) {
+        return 1;
+    }
+    if (config.target_length <= 0.0) {
+        printf("A positive --length target is required!\n");
+        return 1;
+    }
+    if (config.snakes < 0 || config.ladders < 0 || config.iterations < 0 || config.chains < 1 || threads < 1) {
+        printf("Counts of snakes, ladders, iterations, chains and threads must not be negative!\n");
+        return 1;
+    }
+    if (!load_board_arg(&start, argc > 1 ? argv[1] : NULL)) {
+        return 1;
+    }
+
+    double begin = now_seconds();
+    int ok = score_board(&config, &start, &start_score) &&
+             optimize_board(&config, &start, threads, &best, &best_score);
+    double elapsed = now_seconds() - begin;
+    board_free(&start);
+    if (!ok) {
+        return 1;
+    }
+
+    char comment[160];
+    snprintf(comment, sizeof(comment), "Optimized for %d players: length %.2f, variance %.1f, "
+             "first-player advantage %+.4f", players, best_score.length, best_score.variance,
+             best_score.advantage);
+    ok = board_save(&best, argv[0], comment);
+    board_free(&best);
+    if (!ok) {
+        return 1;
+    }
+
+    if (config.snakes == 0 && config.ladders == 0) print_board_score("Start:", &start_score);
+    print_board_score("Best:", &best_score);
+    printf("Searched %ld layouts in %d chains in %.2f s, wrote %s\n",
+           config.iterations * config.chains, config.chains, elapsed, argv[0]);
+    return 0;
+}
+
+// Print one optimal roll sequence
+static void print_roll_sequence(void* context, const int* rolls, int count) {
+    (void)context;
+    printf("  ");
+    for (int i = 0; i < count; i++) printf("%s%d", i ? " " : "", rolls[i]);
+    printf("\n");
+}
+
+// Fewest rolls to finish and every roll sequence achieving it
+static int run_reach(int argc, char** argv) {
+    const char* from_arg = take_option(&argc, argv, "--from");
+    const char* sequences_arg = take_option(&argc, argv, "--sequences");
+    int from = from_arg ? atoi(from_arg) : 0;
+    long limit = sequences_arg ? atol(sequences_arg) : 20;
+    ReachBoard reach;
+    ReachTable table;
+    Board board;
+
+    if (!load_board_arg(&board, argc > 0 ? argv[0] : NULL)) {
+        return 1;
+    }
+    if (from < 0 || from >= board.squares) {
+        printf("The start square must be between 0 and %d!\n", board.squares - 1);
+        board_free(&board);
+        return 1;
+    }
+    if (!reach_board_init(&reach, &board)) {
+        board_free(&board);
+        return 1;
+    }
+    if (!reach_solve(&reach, &table)) {
+        reach_board_free(&reach);
+        board_free(&board);
+        return 1;
+    }
+
+    // The forward search from each square must agree with the table
+    int mismatches = 0;
+    for (int square = 0; square < board.squares; square++) {
+        if (table.min_rolls[square] >= 0 && reach_min_rolls(&reach, square) != table.min_rolls[square]) {
+            mismatches++;
+        }
+    }
+
+    // Time both searches over enough repetitions to be measurable
+    int repeats = 1 + 10000000 / (board.squares + 1);
+    volatile int sink = 0;
+    double start = now_seconds();
+    for (int i = 0; i < repeats; i++) sink += reach_min_rolls(&reach, from);
+    double forward_seconds = (now_seconds() - start) / repeats;
+
+    ReachTable timed;
+    int solves = 1 + repeats / 100;
+    start = now_seconds();
+    for (int i = 0; i < solves; i++) {
+        reach_solve(&reach, &timed);
+        reach_free(&timed);
+    }
+    double backward_seconds = (now_seconds() - start) / solves;
+
+    int rolls = table.min_rolls[from];
+    printf("Bitset:             %d x 64 bits (%s)\n", reach.words,
+           reach.words * 64 <= REACH_WIDE_BITS ? "one 128-bit value" : "word array");
+    if (rolls < 0) {
+        printf("Square %d never finishes\n", from);
+    } else {
+        printf("Fewest rolls:       %d from square %d\n", rolls, from);
+        printf("Optimal sequences:  %ld\n", reach_count_sequences(&board, &table, from));
+        reach_list_sequences(&board, &table, from, limit, print_roll_sequence, NULL);
+    }
+    printf("Worst square:       %d rolls\n", table.max_rolls);
+    printf("Forward search:     %.1f ns\n", forward_seconds * 1e9);
+    printf("All squares:        %.1f ns\n", backward_seconds * 1e9);
+    if (mismatches > 0) printf("%d squares disagree between the forward and backward searches!\n", mismatches);
+
+    reach_free(&table);
+    reach_board_free(&reach);
+    board_free(&board);
+    return mismatches == 0 ? 0 : 1;
+}
+
+// Solve (or load) the choose-your-roll policy table of a board
+static int run_policy(int argc, char** argv) {
+    const char* cache = take_option(&argc, argv, "--cache");
+    int from_a = 0, from_b = 0;
+    const char* path = NULL;
+    PolicyTable table;
+    ReachBoard reach;
+    ReachTable min_rolls;
+    Board board;
+
+    for (int i = 0; i < argc; i++) {
+        if (strcmp(argv[i], "--from") == 0 && i + 2 < argc) {
+            from_a = atoi(argv[++i]);
+            from_b = atoi(argv[++i]);
+        } else {
+            path = argv[i];
+        }
+    }
+    if (!load_board_arg(&board, path)) {
+        return 1;
+    }
+    if (from_a < 0 || from_a >= board.squares || from_b < 0 || from_b >= board.squares) {
+        printf("Positions must be between 0 and %d!\n", board.squares - 1);
+        board_free(&board);
+        return 1;
+    }
+
+    double start = now_seconds();
+    int loaded = cache && policy_load(&table, &board, cache);
+    if (!loaded && !policy_solve(&board, &table)) {
+        board_free(&board);
+        return 1;
+    }
+    double elapsed = now_seconds() - start;
+    if (cache && !loaded) policy_save(&table, cache);
+
+    long counts[3] = {0, 0, 0};
+    long states = (long)board.squares * board.squares;
+    for (long state = 0; state < states; state++) {
+        counts[table.entries[state] >> POLICY_OUTCOME_SHIFT]++;
+    }
+
+    // Players never block each other, so with perfect play the mover wins
+    // exactly when its own fewest rolls are no more than the other's
+    int mismatches = 0;
+    int ok = reach_board_init(&reach, &board);
+    if (ok && reach_solve(&reach, &min_rolls)) {
+        for (int mover = 0; mover < board.squares; mover++) {
+            for (int other = 0; other < board.squares; other++) {
+                int m = min_rolls.min_rolls[mover], o = min_rolls.min_rolls[other];
+                if (m < 0 || o < 0) continue;
+                if ((policy_outcome(&table, mover, other) == POLICY_WIN) != (m <= o)) mismatches++;
+            }
+        }
+        reach_free(&min_rolls);
+    }
+    if (ok) reach_board_free(&reach);
+
+    // Lookups over every state, timed
+    volatile int sink = 0;
+    int rounds = 1 + 20000000 / (int)states;
+    double lookup_start = now_seconds();
+    for (int round = 0; round < rounds; round++) {
+        for (int mover = 0; mover < board.squares; mover++) {
+            for (int other = 0; other < board.squares; other++) sink += policy_best_roll(&table, mover, other);
+        }
+    }
+    double lookup_seconds = (now_seconds() - lookup_start) / ((double)rounds * states);
+
+    const char* names[3] = {"draw", "win", "loss"};
+    printf("Policy table:       %ld states, %ld bytes, %s in %.2f ms\n", states, states,
+           loaded ? "loaded" : "solved", elapsed * 1e3);
+    printf("States:             %ld won, %ld lost, %ld drawn by the mover\n",
+           counts[POLICY_WIN], counts[POLICY_LOSS], counts[POLICY_DRAW]);
+    printf("Position:           A on %d, B on %d, A to move: %s, best roll %d\n", from_a, from_b,
+           names[policy_outcome(&table, from_a, from_b)], policy_best_roll(&table, from_a, from_b));
+    printf("Lookup:             %.2f ns\n", lookup_seconds * 1e9);
+    if (!ok) printf("Could not check the table against the fewest-roll search!\n");
+    if (mismatches > 0) printf("%d states disagree with the fewest-roll search!\n", mismatches);
+
+    policy_free(&table);
+    board_free(&board);
+    return ok && mismatches == 0 ? 0 : 1;
+}
+
+// Play the expectimax player against one moving at random, for a variant
+static int run_ai(int argc, char** argv) {
+    const char* games_arg = take_option(&argc, argv, "--games");
+    const char* budget_arg = take_option(&argc, argv, "--budget");
+    const char* seed_arg = take_option(&argc, argv, "--seed");
+    const char* tokens_arg = take_option(&argc, argv, "--tokens");
+    long games = games_arg ? atol(games_arg) : 100;
+    int budget = budget_arg ? atoi(budget_arg) : 20;
+    uint64_t seed = seed_arg ? strtoull(seed_arg, NULL, 0) : 1;
+    VariantRules rules = {tokens_arg ? atoi(tokens_arg) : 2, 0, 0, 0};
+    const char* path = NULL;
+    AiSearch search;
+    Board board;
+
+    for (int i = 0; i < argc; i++) {
+        if (strcmp(argv[i], "--exact") == 0) {
+            rules.exact_finish = 1;
+        } else if (strcmp(argv[i], "--bonus") == 0) {
+            rules.bonus_six = 1;
+        } else if (strcmp(argv[i], "--chosen") == 0) {
+            rules.chosen_rolls = 1;
+        } else {
+            path = argv[i];
+        }
+    }
+    if (games <= 0 || budget <= 0) {
+        printf("Games and budget must be positive!\n");
+        return 1;
+    }
+    if (!load_board_arg(&board, path)) {
+        return 1;
+    }
+    if (!ai_init(&search, &board, &rules, AI_DEFAULT_TABLE_ENTRIES)) {
+        board_free(&board);
+        return 1;
+    }
+
+    // The computer takes the first seat in even games and the second in odd
+    // ones; its opponent picks uniformly among its legal moves
+    long wins = 0, unfinished = 0, searches = 0, depths = 0, nodes = 0, slowest_ms = 0;
+    double thinking = 0.0;
+    for (long game = 0; game < games; game++) {
+        DiceSource dice;
+        VariantState state;
+        int ai_seat = (int)(game % 2);
+
+        dice_seed(&dice, game_seed(seed, game));
+        variant_init(&state);
+        for (int ply = 0; ply < AI_MAX_PLIES && state.winner < 0; ply++) {
+            int roll = rules.chosen_rolls ? 0 : dice_roll(&dice);
+            AiMove moves[DICE_SIDES * AI_MAX_TOKENS];
+            AiMove move;
+
+            if (state.current == ai_seat) {
+                AiResult result;
+                double start = now_seconds();
+                ai_choose_move(&search, &state, roll, budget, &result);
+                double ms = (now_seconds() - start) * 1e3;
+                move = result.move;
+                if (result.depth > 0) {
+                    searches++;
+                    depths += result.depth;
+                    nodes += result.nodes;
+                    thinking += ms;
+                    if (ms > slowest_ms) slowest_ms = (long)ms;
+                }
+            } else {
+                int count = variant_legal_moves(&board, &rules, &state, roll, moves);
+                move = moves[(dice_roll(&dice) - 1) * count / DICE_SIDES];
+            }
+            variant_apply(&board, &rules, &state, move);
+        }
+        if (state.winner == ai_seat) wins++;
+        if (state.winner < 0) unfinished++;
+    }
+
+    printf("Variant:            %d token%s%s%s%s\n", rules.tokens, rules.tokens == 1 ? "" : "s",
+           rules.exact_finish ? ", exact finish" : "", rules.bonus_six ? ", bonus six" : "",
+           rules.chosen_rolls ? ", chosen rolls" : "");
+    printf("Games:              %ld, computer won %ld (%.1f%%), %ld unfinished\n",
+           games, wins, 100.0 * wins / games, unfinished);
+    if (searches > 0) {
+        printf("Searches:           %ld, average depth %.1f, %.0f ms average, %ld ms slowest\n",
+               searches, (double)depths / searches, thinking / searches, slowest_ms);
+        printf("Speed:              %.0f nodes/s\n", thinking > 0 ? nodes / (thinking / 1e3) : 0.0);
+    } else {
+        printf("Searches:           none; the variant left no choices\n");
+    }
+
+    ai_free(&search);
+    board_free(&board);
+    return 0;
+}
+
+// Round robin between choose-your-roll strategies on all cores. Everything
+// on stdout depends only on the arguments; the timing goes to stderr.
+static int run_tournament(int argc, char** argv) {
+    const char* strategies_arg = take_option(&argc, argv, "--strategies");
+    const char* matches_arg = take_option(&argc, argv, "--matches");
+    const char* seed_arg = take_option(&argc, argv, "--seed");
+    const char* depth_arg = take_option(&argc, argv, "--depth");
+    const char* threads_arg = take_option(&argc, argv, "--threads");
+    char names[256];
+    TournamentConfig config;
+    TournamentResult result;
+    Board board;
+
+    memset(&config, 0, sizeof(config));
+    config.matches = matches_arg ? atol(matches_arg) : 100000;
+    config.seed = seed_arg ? strtoull(seed_arg, NULL, 0) : 1;
+    config.depth = depth_arg ? atoi(depth_arg) : TOURNAMENT_DEFAULT_DEPTH;
+    config.threads = threads_arg ? atoi(threads_arg) : runner_default_threads();
+    if (config.threads < 1) {
+        printf("Number of threads must be positive!\n");
+        return 1;
+    }
+
+    snprintf(names, sizeof(names), "%s", strategies_arg ? strategies_arg : "random,greedy,policy,expectimax");
+    for (char* name = strtok(names, ","); name; name = strtok(NULL, ",")) {
+        int kind = tournament_strategy_by_name(name);
+        if (kind < 0) {
+            printf("Unknown strategy %s!\n", name);
+            return 1;
+        }
+        if (config.entrants == TOURNAMENT_MAX_ENTRANTS) {
+            printf("A tournament has at most %d entrants!\n", TOURNAMENT_MAX_ENTRANTS);
+            return 1;
+        }
+        config.entrant[config.entrants++] = (StrategyKind)kind;
+    }
+    if (!load_board_arg(&board, argc > 0 ? argv[0] : NULL)) {
+        return 1;
+    }
+    config.board = &board;
+
+    double start = now_seconds();
+    if (!tournament_run(&config, &result)) {
+        board_free(&board);
+        return 1;
+    }
+    double elapsed = now_seconds() - start;
+
+    printf("Tournament:         %d entrants, %ld matches per pairing, seed %llu, expectimax depth %d\n",
+           config.entrants, config.matches, (unsigned long long)config.seed, config.depth);
+    printf("%-24s %10s %10s %8s %8s  %-17s %7s\n", "Pairing", "Wins", "Losses", "Draws", "Score",
+           "95% interval", "Plies");
+    for (int p = 0; p < result.pairings; p++) {
+        const PairingResult* pairing = &result.pairing[p];
+        char label[64];
+        double low, high, score = pairing->wins_a + 0.5 * pairing->draws;
+        snprintf(label, sizeof(label), "%s vs %s", tournament_strategies[config.entrant[pairing->a]].name,
+                 tournament_strategies[config.entrant[pairing->b]].name);
+        tournament_interval(score, (double)config.matches, &low, &high);
+        printf("%-24s %10ld %10ld %8ld %7.2f%%  %6.2f%% - %6.2f%% %7.1f\n", label, pairing->wins_a,
+               pairing->wins_b, pairing->draws, 100.0 * score / config.matches, 100.0 * low,
+               100.0 * high, (double)pairing->total_plies / config.matches);
+    }
+
+    // Entrants by rating, best first
+    int order[TOURNAMENT_MAX_ENTRANTS];
+    for (int i = 0; i < config.entrants; i++) {
+        int at = i;
+        while (at > 0 && result.elo[order[at - 1]] < result.elo[i]) {
+            order[at] = order[at - 1];
+            at--;
+        }
+        order[at] = i;
+    }
+    printf("Ratings:\n");
+    for (int i = 0; i < config.entrants; i++) {
+        printf("  %d. %-12s %7.1f\n", i + 1, tournament_strategies[config.entrant[order[i]]].name,
+               result.elo[order[i]]);
+    }
+    printf("Digest:             %016llx\n", (unsigned long long)tournament_digest(&result));
+
+    long matches = config.matches * result.pairings;
+    fprintf(stderr, "%ld matches in %.2f s (%.0f matches/s) on %d threads\n", matches, elapsed,
+            matches / elapsed, config.threads);
+
+    board_free(&board);
+    return 0;
+}
+
+// Check a seed's dice stream: sequential rolls against rolls computed
+// directly and after jumps, then the spread of the faces and the roll rate
+static int run_dice(int argc, char** argv) {
+    const char* rolls_arg = take_option(&argc, argv, "--rolls");
+    uint64_t seed = argc > 0 ? strtoull(argv[0], NULL, 0) : 1;
+    long rolls = rolls_arg ? atol(rolls_arg) : 100000000;
+    long counts[DICE_SIDES + 1] = {0};
+    long mismatches = 0;
+    DiceSource dice;
+
+    if (rolls <= 0) {
+        printf("Number of rolls must be positive!\n");
+        return 1;
+    }
+
+    // Every roll of the first stretch, and stretches after jumps spread
+    // over the whole run, must match the direct computation
+    long checked = rolls < DICE_CHECK_ROLLS ? rolls : DICE_CHECK_ROLLS;
+    dice_seed(&dice, seed);
+    for (long i = 0; i < checked; i++) {
+        if (dice_roll(&dice) != dice_roll_at(seed, (uint64_t)i)) mismatches++;
+    }
+    for (int jump = 1; jump <= DICE_CHECK_JUMPS; jump++) {
+        uint64_t first = (uint64_t)rolls * jump / (DICE_CHECK_JUMPS + 1) + jump;
+        dice_seek(&dice, first);
+        for (uint64_t i = first; i < first + DICE_BUFFER_ROLLS * 2; i++) {
+            if (dice_roll(&dice) != dice_roll_at(seed, i)) mismatches++;
+        }
+    }
+
+    dice_seed(&dice, seed);
+    double start = now_seconds();
+    for (long i = 0; i < rolls; i++) counts[dice_roll(&dice)]++;
+    double elapsed = now_seconds() - start;
+
+    // Chi-square against a fair die, 5 degrees of freedom
+    double expected = (double)rolls / DICE_SIDES, chi_square = 0.0;
+    printf("Rolls:              %ld from seed %llu\n", rolls, (unsigned long long)seed);
+    for (int face = 1; face <= DICE_SIDES; face++) {
+        double off = counts[face] - expected;
+        chi_square += off * off / expected;
+        printf("Face %d:             %ld (%.4f%%)\n", face, counts[face], 100.0 * counts[face] / rolls);
+    }
+    printf("Chi-square:         %.2f (5 degrees of freedom; above 20.5 in 1 of 1000 fair runs)\n", chi_square);
+    printf("Rolls/second:       %.0f\n", rolls / elapsed);
+    if (mismatches > 0) printf("%ld rolls differ from their direct computation!\n", mismatches);
+    return mismatches == 0 ? 0 : 1;
+}
+
+// Print command-line help
+static void print_usage(const char* program) {
+    printf("Usage: %s simulate [games] [seed] [board file] [--players N] [--threads N] [--kernel scalar|lockstep]\n", program);
+    printf("       %s exact [board file] [--players N] [--dist]\n", program);
+    printf("       %s record <replay file> [games] [seed] [board file] [--players N]\n", program);
+    printf("       %s replay <replay file> [board file] [--game N] [--turn T]\n", program);
+    printf("       %s analyze <replay file> [board file] [--threads N]\n", program);
+    printf("       %s optimize <output board> [start board] --length L [--variance V] [--advantage A]\n"
+           "                [--snakes N --ladders N] [--iterations N] [--chains N] [--seed S]\n"
+           "                [--players N] [--threads N]\n", program);
+    printf("       %s reach [board file] [--from S] [--sequences N]\n", program);
+    printf("       %s policy [board file] [--cache FILE] [--from A B]\n", program);
+    printf("       %s ai [board file] [--tokens N] [--exact] [--bonus] [--chosen]\n"
+           "                [--games N] [--budget MS] [--seed S]\n", program);
+    printf("       %s tournament [board file] [--strategies a,b,...] [--matches N] [--seed S]\n"
+           "                [--depth D] [--threads N]\n", program);
+    printf("       %s dice [seed] [--rolls N]\n", program);
+}
+
+// Main function
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    if (strcmp(argv[1], "simulate") == 0) return run_simulate(argc - 2, argv + 2);
+    if (strcmp(argv[1], "exact") == 0) return run_exact(argc - 2, argv + 2);
+    if (strcmp(argv[1], "record") == 0) return run_record(argc - 2, argv + 2);
+    if (strcmp(argv[1], "replay") == 0) return run_replay(argc - 2, argv + 2);
+    if (strcmp(argv[1], "analyze") == 0) return run_analyze(argc - 2, argv + 2);
+    if (strcmp(argv[1], "optimize") == 0) return run_optimize(argc - 2, argv + 2);
+    if (strcmp(argv[1], "reach") == 0) return run_reach(argc - 2, argv + 2);
+    if (strcmp(argv[1], "policy") == 0) return run_policy(argc - 2, argv + 2);
+    if (strcmp(argv[1], "ai") == 0) return run_ai(argc - 2, argv + 2);
+    if (strcmp(argv[1], "tournament") == 0) return run_tournament(argc - 2, argv + 2);
+    if (strcmp(argv[1], "dice") == 0) return run_dice(argc - 2, argv + 2);
+
+    print_usage(argv[0]);
+    return 1;
+}
@@ -0,0 +1,304 @@
+/*SNAKE & LADDER GAME - STRATEGY TOURNAMENT*/
+// Strategies play the SDL game's rule, choosing the number they move, in a
+// two-player round robin. Matches are numbered within their pairing and
+// each draws its dice from a stream seeded by that number, and expectimax
+// searches to a fixed depth with no clock. Every match therefore plays out
+// the same way on any thread, and since workers only add to their own
+// counters, the merged results are identical for any thread count.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "snake_ladder_tournament.h"
+#include "snake_ladder_runner.h"
+
+#define FNV_OFFSET_BASIS 0xCBF29CE484222325ULL
+#define FNV_PRIME 0x100000001B3ULL
+
+// Throw the die
+static int choose_random(StrategyContext* context, const Game* game) {
+    (void)game;
+    return dice_roll(context->dice);
+}
+
+// The number landing furthest up the board, after any snake or ladder
+static int choose_greedy(StrategyContext* context, const Game* game) {
+    int from = game->position[game->current];
+    int best = 1, best_square = -1;
+
+    for (int roll = 1; roll <= DICE_SIDES; roll++) {
+        int to = board_jump(context->board, from + roll);
+        if (to >= best_square) {
+            best = roll;
+            best_square = to;
+        }
+    }
+    return best;
+}
+
+// Look the position up in the solved table
+static int choose_policy(StrategyContext* context, const Game* game) {
+    int mover = game->current;
+    int roll = policy_best_roll(context->policy, game->position[mover], game->position[1 - mover]);
+    return roll > 0 ? roll : choose_greedy(context, game);
+}
+
+// Search the position as a one-token, chosen-roll variant game
+static int choose_expectimax(StrategyContext* context, const Game* game) {
+    VariantState state;
+    AiResult result;
+
+    variant_init(&state);
+    state.current = game->current;
+    for (int player = 0; player < AI_PLAYERS; player++) state.position[player][0] = game->position[player];
+    ai_choose_move(context->search, &state, 0, 0, &result);
+    return result.move.roll;
+}
+
+const Strategy tournament_strategies[STRATEGY_COUNT] = {
+    {"random", choose_random},
+    {"greedy", choose_greedy},
+    {"policy", choose_policy},
+    {"expectimax", choose_expectimax},
+};
+
+// Index of a strategy name, or -1
+int tournament_strategy_by_name(const char* name) {
+    for (int i = 0; i < STRATEGY_COUNT; i++) {
+        if (strcmp(tournament_strategies[i].name, name) == 0) return i;
+    }
+    return -1;
+}
+
+// One worker's search table and counters, on their own cache lines
+typedef struct {
+    AiSearch search;
+    int search_ready;
+    int failed;
+    PairingResult* results;
+} __attribute__((aligned(64))) TournamentWorker;
+
+// Per-run state of a tournament
+typedef struct {
+    const TournamentConfig* config;
+    const PolicyTable* policy;
+    int uses_search;
+    int pairings;
+    long chunks_per_pairing;
+    int pair_a[TOURNAMENT_MAX_ENTRANTS * TOURNAMENT_MAX_ENTRANTS];
+    int pair_b[TOURNAMENT_MAX_ENTRANTS * TOURNAMENT_MAX_ENTRANTS];
+    TournamentWorker* workers;
+} TournamentJob;
+
+// Play one match; returns the winning seat, or -1 for a draw
+static int play_match(const TournamentJob* job, StrategyContext* context, const StrategyKind* seat,
+                      int* plies) {
+    const Board* board = job->config->board;
+    Game game;
+    TurnResult turn;
+
+    game_init(&game, AI_PLAYERS);
+    while (game.winner < 0 && game.turns < TOURNAMENT_MAX_PLIES) {
+        int roll = tournament_strategies[seat[game.current]].choose(context, &game);
+        game_take_turn(&game, board, roll, &turn);
+    }
+    *plies = game.turns;
+    return game.winner;
+}
+
+// Play one chunk of a pairing's matches into the worker's counters
+static void play_chunk(void* context, int worker, long chunk) {
+    TournamentJob* job = context;
+    const TournamentConfig* config = job->config;
+    TournamentWorker* state = &job->workers[worker];
+    int pairing = (int)(chunk / job->chunks_per_pairing);
+    long first = chunk % job->chunks_per_pairing * TOURNAMENT_CHUNK_MATCHES;
+    long last = first + TOURNAMENT_CHUNK_MATCHES < config->matches ? first + TOURNAMENT_CHUNK_MATCHES
+                                                                   : config->matches;
+
+    // Each worker builds its own search table the first time it needs one
+    if (job->uses_search && !state->search_ready) {
+        VariantRules rules = {1, 0, 0, 1};
+        if (!ai_init(&state->search, config->board, &rules, AI_DEFAULT_TABLE_ENTRIES)) {
+            state->failed = 1;
+            return;
+        }
+        state->search.max_depth = config->depth;
+        state->search_ready = 1;
+    }
+
+    int a = job->pair_a[pairing], b = job->pair_b[pairing];
+    PairingResult* result = &state->results[pairing];
+    DiceSource dice;
+    StrategyContext strategy = {config->board, job->policy, &state->search, &dice};
+
+    for (long match = first; match < last; match++) {
+        // Entrant a moves first in even matches and second in odd ones
+        int a_seat = (int)(match % 2);
+        StrategyKind seat[AI_PLAYERS];
+        seat[a_seat] = config->entrant[a];
+        seat[1 - a_seat] = config->entrant[b];
+
+        int plies;
+        dice_seed(&dice, game_seed(config->seed, (long)pairing * config->matches + match));
+        int winner = play_match(job, &strategy, seat, &plies);
+        if (winner < 0) {
+            result->draws++;
+        } else if (winner == a_seat) {
+            result->wins_a++;
+        } else {
+            result->wins_b++;
+        }
+        result->total_plies += plies;
+    }
+}
+
+// Play every pairing of a round robin on all threads, then rate the entrants
+int tournament_run(const TournamentConfig* config, TournamentResult* result) {
+    TournamentJob job;
+    PolicyTable policy;
+    int threads = config->threads < 1 ? 1 : config->threads;
+    if (threads > RUNNER_MAX_THREADS) threads = RUNNER_MAX_THREADS;
+
+    memset(result, 0, sizeof(*result));
+    memset(&job, 0, sizeof(job));
+    memset(&policy, 0, sizeof(policy));
+    if (config->entrants < 2 || config->entrants > TOURNAMENT_MAX_ENTRANTS) {
+        printf("A tournament needs 2 to %d entrants!\n", TOURNAMENT_MAX_ENTRANTS);
+        return 0;
+    }
+    if (config->matches <= 0 || config->depth < 1 || config->depth > AI_MAX_DEPTH) {
+        printf("Matches must be positive and the depth between 1 and %d!\n", AI_MAX_DEPTH);
+        return 0;
+    }
+
+    job.config = config;
+    for (int a = 0; a < config->entrants; a++) {
+        if (config->entrant[a] == STRATEGY_EXPECTIMAX) job.uses_search = 1;
+        if (config->entrant[a] == STRATEGY_POLICY && policy.entries == NULL) {
+            if (!policy_solve(config->board, &policy)) return 0;
+            job.policy = &policy;
+        }
+        for (int b = a + 1; b < config->entrants; b++) {
+            job.pair_a[job.pairings] = a;
+            job.pair_b[job.pairings] = b;
+            job.pairings++;
+        }
+    }
+    job.chunks_per_pairing = (config->matches + TOURNAMENT_CHUNK_MATCHES - 1) / TOURNAMENT_CHUNK_MATCHES;
+
+    job.workers = aligned_alloc(64, sizeof(TournamentWorker) * threads);
+    PairingResult* counters = calloc((size_t)threads * job.pairings, sizeof(PairingResult));
+    if (job.workers == NULL || counters == NULL) {
+        printf("Out of memory in tournament!\n");
+        free(job.workers);
+        free(counters);
+        policy_free(&policy);
+        return 0;
+    }
+    memset(job.workers, 0, sizeof(TournamentWorker) * threads);
+    for (int i = 0; i < threads; i++) job.workers[i].results = counters + (long)i * job.pairings;
+
+    int ok = run_parallel_chunks(job.chunks_per_pairing * job.pairings, threads, play_chunk, &job);
+
+    result->pairings = job.pairings;
+    for (int p = 0; p < job.pairings; p++) {
+        PairingResult* total = &result->pairing[p];
+        total->a = job.pair_a[p];
+        total->b = job.pair_b[p];
+        for (int i = 0; i < threads; i++) {
+            const PairingResult* part = &job.workers[i].results[p];
+            total->wins_a += part->wins_a;
+            total->wins_b += part->wins_b;
+            total->draws += part->draws;
+            total->total_plies += part->total_plies;
+        }
+    }
+    for (int i = 0; i < threads; i++) {
+        if (job.workers[i].failed) ok = 0;
+        if (job.workers[i].search_ready) ai_free(&job.workers[i].search);
+    }
+    if (ok) tournament_ratings(config, result);
+
+    free(job.workers);
+    free(counters);
+    policy_free(&policy);
+    return ok;
+}
+
+// Elo ratings from a Bradley-Terry fit of every pairing's score, by
+// minorization-maximization. Draws count half a win to each side, and every
+// pairing gets TOURNAMENT_PRIOR_DRAWS extra draws so that no rating runs off
+// to infinity on a perfect record.
+void tournament_ratings(const TournamentConfig* config, TournamentResult* result) {
+    double strength[TOURNAMENT_MAX_ENTRANTS], score[TOURNAMENT_MAX_ENTRANTS];
+    int entrants = config->entrants;
+
+    for (int i = 0; i < entrants; i++) {
+        strength[i] = 1.0;
+        score[i] = 0.0;
+    }
+    for (int p = 0; p < result->pairings; p++) {
+        const PairingResult* pairing = &result->pairing[p];
+        double half = 0.5 * (pairing->draws + TOURNAMENT_PRIOR_DRAWS);
+        score[pairing->a] += pairing->wins_a + half;
+        score[pairing->b] += pairing->wins_b + half;
+    }
+
+    for (int round = 0; round < 10000; round++) {
+        double next[TOURNAMENT_MAX_ENTRANTS], change = 0.0, log_mean = 0.0;
+        for (int i = 0; i < entrants; i++) {
+            double denominator = 0.0;
+            for (int p = 0; p < result->pairings; p++) {
+                const PairingResult* pairing = &result->pairing[p];
+                if (pairing->a != i && pairing->b != i) continue;
+                double games = pairing->wins_a + pairing->wins_b + pairing->draws + TOURNAMENT_PRIOR_DRAWS;
+                denominator += games / (strength[pairing->a] + strength[pairing->b]);
+            }
+            next[i] = score[i] / denominator;
+            log_mean += log(next[i]) / entrants;
+        }
+        // Scale to a geometric mean of 1, so the average rating is fixed
+        for (int i = 0; i < entrants; i++) {
+            next[i] /= exp(log_mean);
+            if (fabs(log(next[i] / strength[i])) > change) change = fabs(log(next[i] / strength[i]));
+            strength[i] = next[i];
+        }
+        if (change < 1e-12) break;
+    }
+
+    for (int i = 0; i < entrants; i++) {
+        result->elo[i] = TOURNAMENT_MEAN_ELO + 400.0 * log10(strength[i]);
+    }
+}
+
+// 95% Wilson score interval of a score out of a number of games
+void tournament_interval(double score, double games, double* low, double* high) {
+    const double z = 1.959963984540054;
+    if (games <= 0) {
+        *low = 0.0;
+        *high = 1.0;
+        return;
+    }
+
+    double p = score / games;
+    double denominator = 1.0 + z * z / games;
+    double center = (p + z * z / (2.0 * games)) / denominator;
+    double half = z * sqrt(p * (1.0 - p) / games + z * z / (4.0 * games * games)) / denominator;
+    *low = center - half > 0.0 ? center - half : 0.0;
+    *high = center + half < 1.0 ? center + half : 1.0;
+}
+
+// Hash of every pairing's counts, to compare runs at a glance
+uint64_t tournament_digest(const TournamentResult* result) {
+    uint64_t hash = FNV_OFFSET_BASIS;
+
+    for (int p = 0; p < result->pairings; p++) {
+        const PairingResult* pairing = &result->pairing[p];
+        int64_t fields[6] = {pairing->a, pairing->b, pairing->wins_a, pairing->wins_b,
+                             pairing->draws, pairing->total_plies};
+        const uint8_t* bytes = (const uint8_t*)fields;
+        for (size_t i = 0; i < sizeof(fields); i++) hash = (hash ^ bytes[i]) * FNV_PRIME;
+    }
+    return hash;
+}
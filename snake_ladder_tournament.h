@@ -0,0 +1,88 @@
+/*SNAKE & LADDER GAME - STRATEGY TOURNAMENT*/
+#ifndef SNAKE_LADDER_TOURNAMENT_H
+#define SNAKE_LADDER_TOURNAMENT_H
+
+#include "snake_ladder_core.h"
+#include "snake_ladder_policy.h"
+#include "snake_ladder_ai.h"
+
+// Matches per unit of work handed between threads
+#define TOURNAMENT_CHUNK_MATCHES 1024
+
+// Plies after which a match is scored as a draw
+#define TOURNAMENT_MAX_PLIES 1000
+
+// Default expectimax depth in plies; tournament searches have no clock so
+// that results repeat
+#define TOURNAMENT_DEFAULT_DEPTH 4
+
+// Rating of the average entrant, and the virtual draw every pairing starts
+// with so that a perfect record still has a finite rating
+#define TOURNAMENT_MEAN_ELO 1500.0
+#define TOURNAMENT_PRIOR_DRAWS 1.0
+
+// What a strategy sees when choosing its number: its own worker's search
+// and dice, so strategies never share state between threads
+typedef struct {
+    const Board* board;
+    const PolicyTable* policy;  // NULL unless a policy player is entered
+    AiSearch* search;           // NULL unless an expectimax player is entered
+    DiceSource* dice;           // this match's dice
+} StrategyContext;
+
+// Choose a number 1-6 for the player to move
+typedef int (*StrategyFunction)(StrategyContext* context, const Game* game);
+
+typedef struct {
+    const char* name;
+    StrategyFunction choose;
+} Strategy;
+
+// Built-in strategies, by name
+typedef enum {
+    STRATEGY_RANDOM,            // a thrown die
+    STRATEGY_GREEDY,            // the number landing furthest up the board
+    STRATEGY_POLICY,            // the solved choose-your-roll table
+    STRATEGY_EXPECTIMAX,        // depth-limited search
+    STRATEGY_COUNT
+} StrategyKind;
+
+extern const Strategy tournament_strategies[STRATEGY_COUNT];
+
+// A round robin: every entrant plays every other one `matches` times,
+// taking the first seat in half of them
+#define TOURNAMENT_MAX_ENTRANTS 8
+
+typedef struct {
+    const Board* board;
+    int entrants;
+    StrategyKind entrant[TOURNAMENT_MAX_ENTRANTS];
+    long matches;               // per pairing
+    uint64_t seed;
+    int depth;                  // expectimax plies
+    int threads;
+} TournamentConfig;
+
+// Results of one pairing, counted from the first-named entrant's side
+typedef struct {
+    int a;
+    int b;
+    long wins_a;
+    long wins_b;
+    long draws;
+    long total_plies;
+} PairingResult;
+
+typedef struct {
+    int pairings;
+    PairingResult pairing[TOURNAMENT_MAX_ENTRANTS * (TOURNAMENT_MAX_ENTRANTS - 1) / 2];
+    double elo[TOURNAMENT_MAX_ENTRANTS];
+} TournamentResult;
+
+int tournament_strategy_by_name(const char* name);
+int tournament_run(const TournamentConfig* config, TournamentResult* result);
+void tournament_ratings(const TournamentConfig* config, TournamentResult* result);
+void tournament_interval(double score, double games, double* low, double* high);
+uint64_t tournament_digest(const TournamentResult* result);
+
+#endif